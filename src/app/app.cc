@@ -47,15 +47,40 @@ SOFTWARE.
 
 void App::artists(std::vector<std::string> const& val_, bool const ignore_case_)
 {
+  _ignore_case = ignore_case_;
+
   for (auto const& e : val_)
   {
-    auto& res = _results.emplace_back(Result());
-    res.artist = ignore_case_ ? String::titlecase(e) : e;
-    res.artist_url = Belle::Util::url_encode(res.artist);
-    res.artist_lowercase = String::lowercase(e);
+    _artists.emplace_back(Pending{e, {}, 0});
+  }
+}
+
+void App::burst(std::size_t const val_)
+{
+  _limiter.burst(val_);
+}
+
+void App::cache(std::string const& val_)
+{
+  if (val_ == "read")
+  {
+    _cache.mode(Cache::Mode::read);
+  }
+  else if (val_ == "readwrite")
+  {
+    _cache.mode(Cache::Mode::readwrite);
+  }
+  else
+  {
+    _cache.mode(Cache::Mode::off);
   }
 }
 
+void App::cache_ttl(std::size_t const val_)
+{
+  _cache.ttl(std::chrono::hours(val_));
+}
+
 void App::color(bool const val_)
 {
   _color = val_;
@@ -66,6 +91,26 @@ void App::count(std::size_t const val_)
   _match_total = val_;
 }
 
+void App::depth(std::size_t const val_)
+{
+  _depth = val_;
+}
+
+void App::dns_ttl(std::size_t const val_)
+{
+  _dns_cache->ttl(std::chrono::seconds(val_));
+}
+
+void App::extract(std::string const& val_)
+{
+  _extract_icu = val_ == "icu";
+}
+
+void App::fast_open(bool const val_)
+{
+  _fast_open = val_;
+}
+
 void App::headers(std::vector<std::string> const& val_)
 {
   for (auto const& kv : val_)
@@ -79,30 +124,158 @@ void App::headers(std::vector<std::string> const& val_)
   }
 }
 
+void App::input(std::string const& val_)
+{
+  if (val_ == "-")
+  {
+    _input = &std::cin;
+  }
+  else
+  {
+    _input_file.open(val_);
+
+    if (! _input_file)
+    {
+      throw std::runtime_error("could not open input file '" + val_ + "'");
+    }
+
+    _input = &_input_file;
+  }
+
+  input_read();
+}
+
+void App::jobs(std::size_t const val_)
+{
+  _jobs = val_;
+}
+
+void App::keepalive(std::size_t const val_)
+{
+  _keepalive = val_;
+}
+
+void App::keepalive_interval(std::size_t const val_)
+{
+  _keepalive_interval = val_;
+}
+
+void App::keepalive_probes(std::size_t const val_)
+{
+  _keepalive_probes = val_;
+}
+
+void App::nodelay(bool const val_)
+{
+  _nodelay = val_;
+}
+
+void App::pages(std::size_t const val_)
+{
+  _pages = val_;
+}
+
+void App::pipeline(std::size_t const val_)
+{
+  _pipeline = val_;
+}
+
 void App::progress(bool const val_)
 {
   _progress = val_;
 }
 
+void App::rate(std::size_t const val_)
+{
+  _limiter.rate(static_cast<double>(val_));
+}
+
+void App::recv_buffer(std::size_t const val_)
+{
+  _recv_buffer = val_;
+}
+
+void App::send_buffer(std::size_t const val_)
+{
+  _send_buffer = val_;
+}
+
+void App::stats(bool const val_)
+{
+  _stats = val_;
+}
+
+void App::stream(bool const val_)
+{
+  _stream = val_;
+}
+
+void App::threads(std::size_t const val_)
+{
+  _threads = val_;
+}
+
 void App::run()
 {
+  if (_artists.empty())
+  {
+    return;
+  }
+
   signal_init();
 
+  _cache.init();
+  _tls_cache->load(_cache.tls_load());
+
   http_init();
 
-  for (;;)
+  do_timer();
+
+  // the calling thread runs the io context alongside the others
+  std::vector<std::thread> threads;
+
+  for (std::size_t i = 1; i < _threads; ++i)
   {
-    do_timer();
-    _http.run();
-    _io.run();
+    threads.emplace_back([&]()
+    {
+      _io.run();
+    });
+  }
 
-    if (! _reconnect)
+  auto const join = [&]()
+  {
+    for (auto& thread : threads)
     {
-      break;
+      thread.join();
     }
+  };
+
+  // the threads are joined on every path,
+  // a throwing handler stops the io context for the others first
+  try
+  {
+    _io.run();
+  }
+  catch (...)
+  {
+    _io.stop();
+    join();
+
+    throw;
+  }
+
+  join();
 
-    _io.restart();
-    std::this_thread::sleep_for(_wait_total);
+  _cache.alias_save();
+
+  if (_tls_cache->changed())
+  {
+    _cache.tls_save(_tls_cache->save());
+  }
+
+  if (_stats)
+  {
+    print_stats();
   }
 
   if (_http_reason.size())
@@ -115,12 +288,12 @@ void App::do_timer()
 {
   if (_progress)
   {
-    _timer.expires_at(_timer.expires_at() + _interval);
+    _timer.expires_after(_interval);
 
-    _timer.async_wait([&](auto ec)
+    _timer.async_wait(Belle::net::bind_executor(_strand, [&](auto ec)
     {
       on_timer(ec);
-    });
+    }));
   }
 }
 
@@ -131,6 +304,9 @@ void App::on_timer(Belle::error_code const& ec_)
     return;
   }
 
+  auto const match_count = _result_print < _result_next ?
+    result_at(_result_print).match.size() : 0;
+
   if (_color)
   {
     std::cerr
@@ -142,16 +318,16 @@ void App::on_timer(Belle::error_code const& ec_)
     << aec::fg_white
     << "["
     << aec::fg_green
-    << _http.status_string()
+    << status_string()
     << aec::fg_white
     << "]"
     << aec::clear;
 
-    if (_results.at(_result_index).match.size())
+    if (match_count)
     {
       std::cerr
       << aec::fg_green
-      << _results.at(_result_index).match.size()
+      << match_count
       << aec::fg_white
       << "/"
       << aec::fg_green
@@ -166,13 +342,13 @@ void App::on_timer(Belle::error_code const& ec_)
     << aec::erase_line
     << _progress_str.at(_progress_index)
     << "["
-    << _http.status_string()
+    << status_string()
     << "]";
 
-    if (_results.at(_result_index).match.size())
+    if (match_count)
     {
       std::cerr
-      << _results.at(_result_index).match.size()
+      << match_count
       << "/"
       << _match_total;
     }
@@ -188,32 +364,12 @@ void App::on_timer(Belle::error_code const& ec_)
   do_timer();
 }
 
-void App::update_wait()
-{
-  auto const match_count = _results.at(_result_index).match.size();
-
-  if (_result_index + 1 == _results.size() && match_count >= _match_total)
-  {
-    return;
-  }
-  else if (match_count < _match_total)
-  {
-    std::this_thread::sleep_for(_interval);
-    _wait_count += _interval;
-
-    return;
-  }
-
-  if (_wait_count < _wait_total)
-  {
-    std::this_thread::sleep_for(_wait_total - _wait_count);
-  }
-}
-
-void App::update_progress()
+void App::update_progress(Conn& conn_, std::size_t const index_)
 {
   if (_progress)
   {
+    auto const& result = result_at(index_);
+
     if (_color)
     {
       std::cerr
@@ -225,11 +381,11 @@ void App::update_progress()
       << aec::fg_white
       << "["
       << aec::fg_green
-      << _http.status_string()
+      << conn_.http.status_string()
       << aec::fg_white
       << "]"
       << aec::fg_green
-      << _results.at(_result_index).match.size()
+      << result.match.size()
       << aec::fg_white
       << "/"
       << aec::fg_green
@@ -243,23 +399,22 @@ void App::update_progress()
       << aec::erase_line
       << _progress_str.at(_progress_index)
       << "["
-      << _http.status_string()
+      << conn_.http.status_string()
       << "]"
-      << _results.at(_result_index).match.size()
+      << result.match.size()
       << "/"
       << _match_total;
     }
   }
-
-  update_wait();
 }
 
 void App::signal_init()
 {
   _sig.on_signal({SIGINT, SIGTERM}, [&](auto const& /*ec*/, auto sig) {
-    _io.stop();
-    _reconnect = false;
-    _http_reason = Belle::Signal::str(sig);
+    Belle::net::dispatch(_strand, [&, sig]() {
+      _io.stop();
+      _http_reason = Belle::Signal::str(sig);
+    });
   });
 
   _sig.wait();
@@ -267,267 +422,1211 @@ void App::signal_init()
 
 void App::http_init()
 {
-  http_init_request();
+  // the number of artists is unknown when reading from input
+  auto const jobs = _input || _depth ? _jobs : std::min(_jobs, _artists.size());
 
-  _http.on_error([&](auto& ctx)
-  {
-    http_close(ctx.ec.message());
-    _timer.cancel();
-  });
+  // each connection carries up to '_pipeline' of the '_pages' requests per artist
+  auto const size = jobs * ((_pages + _pipeline - 1) / _pipeline);
 
-  _http.on_open([&](auto& /*ctx*/)
+  for (std::size_t i = 0; i < size; ++i)
   {
-    _http.write(_req);
-  });
+    auto& conn = _conns.emplace_back(_io, _address, _port);
 
-  _http.on_read([&](auto& ctx)
-  {
-    _wait_count = std::chrono::milliseconds(0);
-    _reconnect = false;
-    _http_status = static_cast<int>(ctx.res.result_int());
+    http_init_conn(conn);
+    http_init_request(conn);
+  }
 
-    if (_http_status != 200)
+  for (auto& conn : _conns)
+  {
+    while (conn.tasks.size() < _pipeline && http_assign(conn))
     {
-      if (_http_status != 301 && _http_status != 302 && ctx.res["location"].empty())
-      {
-        http_close(std::string(ctx.res.reason()));
-
-        return;
-      }
+    }
 
-      http_redirect(ctx);
+    http_start(conn);
+  }
+}
 
-      return;
-    }
+void App::http_init_conn(Conn& conn_)
+{
+  // response bodies are cached as received and decoded by the app
+  conn_.http.decode(false);
 
-    _page = std::move(ctx.res.body());
+  // response buffers keep their storage for the next response
+  conn_.http.recycle(true);
 
-    if (_page.empty())
-    {
-      http_close("received empty response");
+  conn_.http.tls_cache(_tls_cache);
+  conn_.http.dns_cache(_dns_cache);
 
-      return;
-    }
+  // socket tuning, applied to each connection before it connects
+  conn_.http.no_delay(_nodelay);
+  conn_.http.fast_open(_fast_open);
+  conn_.http.send_buffer_size(_send_buffer);
+  conn_.http.recv_buffer_size(_recv_buffer);
+  conn_.http.keep_alive(_keepalive > 0);
+  conn_.http.keep_alive_idle(std::chrono::seconds(_keepalive));
+  conn_.http.keep_alive_interval(std::chrono::seconds(_keepalive_interval));
+  conn_.http.keep_alive_count(_keepalive_probes);
 
-    _it.match(_rx_artist, _page);
+  // the callbacks run on the connection's strand,
+  // the app state is only accessed on the app strand
 
-    if (_it.empty())
+  conn_.http.on_error([&](auto& ctx)
+  {
+    Belle::net::post(_strand, [&, ec = ctx.ec]()
     {
-      http_close("no matches found");
-
-      return;
-    }
+      // requests still in flight once the run has ended are abandoned
+      if (_closing || finished())
+      {
+        return;
+      }
 
-    handle_results();
+      // the peer closed the connection
+      if (ec == Belle::net::error::eof ||
+        ec == Belle::net::error::connection_reset ||
+        ec == Belle::net::error::broken_pipe ||
+        ec == Belle::net::ssl::error::stream_truncated ||
+        ec == Belle::http::error::end_of_stream)
+      {
+        http_reopen(conn_);
 
-    ++_results.at(_result_index).page_count;
+        return;
+      }
 
-    auto const& result = _results.at(_result_index);
+      http_close(ec.message());
+    });
+  });
 
-    if (result.match.size() >= _match_total || result.page_count > _page_total)
+  conn_.http.on_open([&](auto& /*ctx*/)
+  {
+    Belle::net::post(_strand, [&]()
     {
-      print_results();
+      conn_.open = true;
 
-      ++_result_index;
-
-      if (_result_index >= _results.size())
+      if (_closing)
       {
-        http_close();
+        conn_.http.close();
 
         return;
       }
 
-      do_timer();
-    }
+      while (conn_.tasks.size() < _pipeline && http_assign(conn_))
+      {
+      }
 
-    http_next();
+      http_wait(conn_);
+    });
   });
 
-  _http.on_write([&](auto& /*ctx*/)
+  conn_.http.on_close([&](auto& /*ctx*/)
   {
-    _http.read();
-  });
+    Belle::net::post(_strand, [&]()
+    {
+      conn_.open = false;
 
-  _http.on_close([&](auto& /*ctx*/)
-  {
-    _timer.cancel();
-    _io.stop();
+      // reopen the connection while the run is incomplete
+      if (! _closing && _http_reason.empty() && ! finished())
+      {
+        http_reconnect(conn_);
+
+        return;
+      }
+
+      http_closed(conn_);
+    });
   });
 }
 
-void App::http_init_request()
+void App::http_init_request(Conn& conn_)
 {
-  auto const& result = _results.at(_result_index);
-
   for (auto const& [k, v] : _headers)
   {
-    _req.set(k, v);
+    conn_.req.set(k, v);
   }
 
-  _req.keep_alive(true);
-  _req.method(Belle::Method::get);
-  _req.params().emplace("page", std::to_string(result.page_count));
-  _req.target(artist_target(result.artist_url));
-}
-
-void App::http_next()
-{
-  auto const& result = _results.at(_result_index);
-
-  _req.params().clear();
-  _req.params().emplace("page", std::to_string(result.page_count));
-  _req.target(artist_target(result.artist_url));
-
-  _http.write(_req);
+  conn_.req.keep_alive(true);
+  conn_.req.method(Belle::Method::get);
 }
 
-void App::http_redirect(Belle::Client::Http::Session_Ctx const& ctx_)
+bool App::http_assign(Conn& conn_)
 {
-  if (_results.at(_result_index).redirect_count >= _redirect_total)
+  // pages found in the cache are handled in place of a request
+  while (auto const task = task_next())
   {
-    http_close("redirect limit reached (" + std::to_string(_redirect_total) + ")");
+    if (! cache_read(conn_, *task))
+    {
+      conn_.tasks.emplace_back(*task);
 
-    return;
+      return true;
+    }
   }
 
-  auto const redirect = String::match(std::string(ctx_.res["location"]), _rx_redirect);
+  return false;
+}
 
-  if (! redirect)
+void App::http_start(Conn& conn_)
+{
+  if (conn_.started || conn_.closed || conn_.tasks.empty())
   {
-    http_close("invalid redirect URL (" + std::string(ctx_.res["location"]) + ")");
-
     return;
   }
 
-  _reconnect = true;
-  ++_results.at(_result_index).redirect_count;
-
-  auto& result = _results.at(_result_index);
-
-  result.artist_url = redirect->at(1);
-  result.artist = String::replace(Belle::Util::url_decode(result.artist_url),
-    {{"&amp;", "&"}, {"%2B", "+"}});
-  result.artist_lowercase = String::lowercase(result.artist);
-
-  http_next();
-}
-
-void App::http_close(std::string const& msg_)
-{
-  _http_reason = msg_;
-  _http.close();
+  conn_.started = true;
+  conn_.http.run();
 }
 
-void App::handle_results()
+void App::http_wake()
 {
-  std::string artist;
-  std::unordered_map<std::string, std::string> cache;
-  auto& result = _results.at(_result_index);
-
-  _timer.cancel();
-
-  if (result.page_count == 1)
-  {
-    print_artist();
-  }
-
-  for (auto const& match : _it)
+  for (auto& conn : _conns)
   {
-    artist = match.group.at(0);
-
-    if (auto const cached = cache.find(artist);
-      cached != cache.end())
+    if (_closing)
     {
-      artist = cached->second;
+      return;
     }
-    else
+
+    if (! conn.started)
     {
-      artist = String::replace(Belle::Util::url_decode(artist), {{"&amp;", "&"}, {"%2B", "+"}});
+      while (conn.tasks.size() < _pipeline && http_assign(conn))
+      {
+      }
+
+      http_start(conn);
+
+      continue;
     }
 
-    if (artist.at(0) != ' ' &&
-      String::lowercase(artist) == result.artist_lowercase)
+    if (! conn.open)
     {
       continue;
     }
 
-    if (auto const it = result.match.insert(artist); it.second)
-    {
-      result.index.emplace_back(it.first);
+    bool assigned {false};
 
-      update_progress();
+    while (conn.tasks.size() < _pipeline && http_assign(conn))
+    {
+      assigned = true;
+    }
 
-      if (result.match.size() >= _match_total)
-      {
-        break;
-      }
+    if (assigned)
+    {
+      http_wait(conn);
     }
   }
 }
 
-void App::print_artist() const
+void App::http_wait(Conn& conn_)
 {
-  if (_progress)
+  if (conn_.waiting || conn_.written == conn_.tasks.size())
   {
-    std::cerr
-    << aec::cr
-    << aec::erase_line;
+    return;
   }
 
-  auto const& result = _results.at(_result_index);
+  conn_.waiting = true;
 
-  if (_color)
-  {
-    std::cout
-    << aec::bold
-    << aec::fg_magenta
-    << result.artist
-    << aec::clear
-    << aec::nl
-    << std::flush;
-  }
-  else
+  // each request written takes a token
+  _limiter.wait(_address, [&](auto ec)
   {
-    std::cout
-    << result.artist
-    << aec::nl
-    << std::flush;
-  }
+    Belle::net::dispatch(_strand, [&, ec]()
+    {
+      conn_.waiting = false;
+
+      if (ec || _closing || ! conn_.open)
+      {
+        return;
+      }
+
+      http_next(conn_);
+    });
+  });
 }
 
-void App::print_results() const
+void App::http_next(Conn& conn_)
 {
-  if (_progress)
+  // unwritten requests for results completed in the meantime are dropped
+  while (conn_.written < conn_.tasks.size() &&
+    result_done(conn_.tasks.at(conn_.written).result_index))
   {
-    std::cerr
-    << aec::cr
-    << aec::erase_line;
+    conn_.tasks.erase(conn_.tasks.begin() + static_cast<std::ptrdiff_t>(conn_.written));
   }
 
-  auto const& result = _results.at(_result_index);
-
-  if (result.match.size())
+  // unwritten requests are sent once the connection is reopened
+  if (conn_.reconnect || conn_.written == conn_.tasks.size())
   {
-    for (auto const& artist : result.index)
-    {
-      if (_color)
+    return;
+  }
+
+  auto const task = conn_.tasks.at(conn_.written++);
+  auto const& result = result_at(task.result_index);
+
+  conn_.req.params().clear();
+  conn_.req.params().emplace("page", std::to_string(task.page_count));
+  conn_.req.target(artist_target(result.artist_url));
+
+  auto const id = ++conn_.request_id;
+
+  // the request is written without waiting on earlier responses,
+  // its response is parsed on the connection's strand,
+  // with the extractor, the body is scanned as it arrives
+  conn_.http.pipeline(conn_.req, [&, task, id, key = task_key(task)](auto& ctx)
+  {
+    Belle::net::post(_strand, [&, task, reply = http_parse(conn_, ctx, key, id)]() mutable
+    {
+      http_read(conn_, task, reply);
+      _match_pool.give(std::move(reply.matches));
+    });
+  },
+  _extract_icu ? Belle::Client::Http::fn_on_data() : [&, task, id](auto& ctx, auto data)
+  {
+    http_data(conn_, ctx, task, id, data);
+  });
+
+  http_wait(conn_);
+}
+
+void App::http_data(Conn& conn_, Belle::Client::Http::Session_Ctx& ctx_, Task const& task_, std::size_t const id_, std::string_view const data_)
+{
+  if (ctx_.res.result_int() != 200)
+  {
+    return;
+  }
+
+  // the first part of a new response body
+  if (conn_.scan_id != id_)
+  {
+    conn_.scan_id = id_;
+    conn_.scan_size = 0;
+    conn_.scan.clear();
+    conn_.page.clear();
+    conn_.inflate.reset();
+    conn_.extract.reset();
+  }
+
+  conn_.scan_size += data_.size();
+
+  // the body is kept as received for the cache
+  if (_cache.write())
+  {
+    conn_.page.append(data_);
+  }
+
+  if (conn_.scan.full)
+  {
+    return;
+  }
+
+  auto const scan = [&](std::string_view const str_) {
+    if (! conn_.scan.full)
+    {
+      conn_.extract.feed(str_, [&](std::string_view const match_) {
+        return handle_match(conn_.scan, match_);
+      });
+    }
+  };
+
+  if (auto const encoding = ctx_.res["content-encoding"];
+    encoding == "gzip" || encoding == "deflate")
+  {
+    conn_.inflate.write(data_, scan);
+  }
+  else
+  {
+    scan(data_);
+  }
+
+  // matches are merged while the rest of the page is read
+  if (conn_.scan.matches.size() > conn_.scan.posted)
+  {
+    auto matches = _match_pool.take();
+    auto const capacity = matches.capacity();
+    matches.assign(std::make_move_iterator(conn_.scan.matches.begin() +
+      static_cast<std::ptrdiff_t>(conn_.scan.posted)),
+      std::make_move_iterator(conn_.scan.matches.end()));
+    _match_pool.count(capacity, matches);
+    conn_.scan.posted = conn_.scan.matches.size();
+
+    Belle::net::post(_strand, [&, task_, matches = std::move(matches)]() mutable
+    {
+      http_partial(conn_, task_, matches);
+      _match_pool.give(std::move(matches));
+    });
+  }
+}
+
+App::Reply App::http_parse(Conn& conn_, Belle::Client::Http::Session_Ctx& ctx_, std::string const& key_, std::size_t const id_)
+{
+  Reply reply;
+
+  reply.status = static_cast<int>(ctx_.res.result_int());
+  reply.keep_alive = ctx_.res.keep_alive();
+
+  if (reply.status != 200)
+  {
+    reply.reason = std::string(ctx_.res.reason());
+    reply.location = std::string(ctx_.res["location"]);
+
+    if ((reply.status == 301 || reply.status == 302) && reply.location.size())
+    {
+      _cache.put(key_, Cache::Entry{reply.status, {}, reply.location});
+    }
+
+    return reply;
+  }
+
+  auto const encoding = std::string(ctx_.res["content-encoding"]);
+
+  // the body was scanned as it arrived
+  if (conn_.scan_id == id_)
+  {
+    if (conn_.scan_size == 0)
+    {
+      reply.empty = true;
+
+      return reply;
+    }
+
+    _cache.put(key_, Cache::Entry{reply.status, encoding, conn_.page});
+
+    // only the matches not already passed on
+    reply.matches = _match_pool.take();
+    auto const capacity = reply.matches.capacity();
+    reply.matches.assign(std::make_move_iterator(conn_.scan.matches.begin() +
+      static_cast<std::ptrdiff_t>(conn_.scan.posted)),
+      std::make_move_iterator(conn_.scan.matches.end()));
+    _match_pool.count(capacity, reply.matches);
+    reply.partial = conn_.scan.posted != 0;
+    conn_.scan.clear();
+
+    return reply;
+  }
+
+  if (ctx_.res.body().empty())
+  {
+    reply.empty = true;
+
+    return reply;
+  }
+
+  _cache.put(key_, Cache::Entry{reply.status, encoding, ctx_.res.body()});
+
+  page_decode(conn_.inflate, encoding, ctx_.res.body(), conn_.page);
+
+  handle_page(conn_.it, conn_.extract, conn_.page, conn_.scan);
+
+  // the scan keeps a spare vector in place of the one passed on
+  reply.matches = _match_pool.take();
+  std::swap(reply.matches, conn_.scan.matches);
+  conn_.scan.clear();
+
+  return reply;
+}
+
+void App::http_read(Conn& conn_, Task const& task_, Reply& reply_)
+{
+  if (_closing)
+  {
+    return;
+  }
+
+  // responses arrive in the order the requests were written
+  conn_.tasks.pop_front();
+  --conn_.written;
+
+  conn_.reconnect_count = 0;
+
+  // the peer closes the connection after this response
+  if (! reply_.keep_alive)
+  {
+    http_reopen(conn_);
+  }
+
+  // discard responses that arrive after their result has completed
+  if (result_done(task_.result_index))
+  {
+    http_wake();
+
+    return;
+  }
+
+  if (reply_.status != 200)
+  {
+    if (reply_.status != 301 && reply_.status != 302 && reply_.location.empty())
+    {
+      http_close(reply_.reason);
+
+      return;
+    }
+
+    http_redirect(conn_, task_, reply_.location);
+
+    return;
+  }
+
+  if (reply_.empty)
+  {
+    http_close("received empty response");
+
+    return;
+  }
+
+  auto& page = result_at(task_.result_index).pages[task_.page_count];
+
+  // the page was merged as it was read
+  if (! reply_.partial)
+  {
+    page.matches.clear();
+  }
+
+  page_merge(page, reply_.matches);
+  page.done = true;
+
+  if (page.matches.empty() && task_.page_count == 1)
+  {
+    http_close("no matches found");
+
+    return;
+  }
+
+  handle_results(conn_, task_.result_index);
+
+  if (finished())
+  {
+    http_close();
+
+    return;
+  }
+
+  http_wake();
+}
+
+void App::http_partial(Conn& conn_, Task const& task_, std::vector<Similar>& matches_)
+{
+  if (_closing || result_done(task_.result_index))
+  {
+    return;
+  }
+
+  auto& result = result_at(task_.result_index);
+
+  if (task_.page_count < result.page_count)
+  {
+    return;
+  }
+
+  // a page read again after a reconnect starts over, the matches
+  // already merged are skipped as duplicates
+  page_merge(result.pages[task_.page_count], matches_);
+
+  handle_results(conn_, task_.result_index);
+
+  if (finished())
+  {
+    http_close();
+
+    return;
+  }
+
+  http_wake();
+}
+
+void App::http_reopen(Conn& conn_)
+{
+  if (conn_.reconnect)
+  {
+    return;
+  }
+
+  // the connection failed while connecting or in the handshake,
+  // there is no open session to close, so it is a failed attempt
+  if (! conn_.open)
+  {
+    http_reconnect(conn_, true);
+
+    return;
+  }
+
+  conn_.reconnect = true;
+  conn_.http.close();
+}
+
+void App::http_reconnect(Conn& conn_, bool const failed_)
+{
+  conn_.reconnect = false;
+
+  if ((conn_.tasks.size() || failed_) && ++conn_.reconnect_count > _reconnect_total)
+  {
+    http_close("reconnect limit reached (" + std::to_string(_reconnect_total) + ")");
+
+    return;
+  }
+
+  // requests still waiting on a response are written again once reopened,
+  // less those for results completed in the meantime
+  conn_.tasks.erase(std::remove_if(conn_.tasks.begin(), conn_.tasks.end(),
+    [&](auto const& task) { return result_done(task.result_index); }),
+    conn_.tasks.end());
+  conn_.written = 0;
+
+  conn_.http.run();
+}
+
+void App::http_redirect(Conn& conn_, Task const& task_, std::string const& location_)
+{
+  if (! result_redirect(task_.result_index, location_))
+  {
+    if (! _closing)
+    {
+      http_wake();
+    }
+
+    return;
+  }
+
+  // the redirected request is written next, without waiting on the limiter
+  conn_.tasks.insert(conn_.tasks.begin() + static_cast<std::ptrdiff_t>(conn_.written), task_);
+
+  http_next(conn_);
+}
+
+void App::http_close(std::string const& msg_)
+{
+  if (_closing)
+  {
+    return;
+  }
+
+  _closing = true;
+  _limiter.cancel();
+
+  // an error on any connection ends the run
+  if (_http_reason.empty())
+  {
+    _http_reason = msg_;
+  }
+
+  for (auto& conn : _conns)
+  {
+    conn.reconnect = false;
+
+    if (conn.open)
+    {
+      conn.http.close();
+    }
+    else if (! conn.closed)
+    {
+      http_closed(conn);
+    }
+  }
+}
+
+void App::http_closed(Conn& conn_)
+{
+  conn_.closed = true;
+
+  if (std::all_of(_conns.begin(), _conns.end(),
+    [](auto const& conn) { return conn.closed; }))
+  {
+    _timer.cancel();
+    _io.stop();
+  }
+}
+
+std::optional<App::Task> App::task_next()
+{
+  if (_closing)
+  {
+    return {};
+  }
+
+  // prefer the next page of an artist already being fetched
+  for (auto i = _result_print; i < _result_next; ++i)
+  {
+    auto& result = result_at(i);
+
+    if (! result.done && result.page_next <= _page_total &&
+      result.page_next < result.page_count + _pages)
+    {
+      return Task{i, result.page_next++};
+    }
+  }
+
+  // otherwise start on the next artist, seeds before crawled artists
+  if ((_artists.size() || _frontier.size()) && _result_next - _result_print < _jobs)
+  {
+    auto& pending = _artists.size() ? _artists : _frontier;
+    auto const& next = pending.front();
+
+    auto& result = _results.emplace_back(Result());
+    result.depth = next.depth;
+
+    if (next.artist_url.empty())
+    {
+      result.artist = _ignore_case ? String::titlecase(next.artist) : next.artist;
+      result.artist_url = Belle::Util::url_encode(result.artist);
+      result.artist_key = OB::Text::fold_key(next.artist);
+
+      // a known alias goes straight to the canonical url,
+      // following the same number of hops as a redirect would
+      for (std::size_t i = 0; i < _redirect_total; ++i)
+      {
+        auto const alias = _cache.alias(result.artist_key);
+
+        if (! alias || *alias == result.artist_url)
+        {
+          break;
+        }
+
+        result.artist_url = *alias;
+        result.artist = _rp_artist(Belle::Util::url_decode(result.artist_url));
+        result.artist_key = OB::Text::fold_key(result.artist);
+      }
+
+      if (_depth)
+      {
+        _visited.insert(String::lowercase(result.artist_url));
+      }
+    }
+    else
+    {
+      result.artist = next.artist;
+      result.artist_url = next.artist_url;
+      result.artist_key = OB::Text::fold_key(next.artist);
+    }
+
+    pending.pop_front();
+    input_read();
+
+    return Task{_result_next++, result.page_next++};
+  }
+
+  return {};
+}
+
+std::string App::task_key(Task const& task_) const
+{
+  return artist_target(result_at(task_.result_index).artist_url) +
+    "?page=" + std::to_string(task_.page_count);
+}
+
+bool App::cache_read(Conn& conn_, Task const& task_)
+{
+  if (! _cache.read())
+  {
+    return false;
+  }
+
+  auto entry = _cache.get(task_key(task_));
+
+  if (! entry)
+  {
+    return false;
+  }
+
+  if (entry->status != 200)
+  {
+    auto const url = result_at(task_.result_index).artist_url;
+
+    // the result was dropped or the run has ended
+    if (! result_redirect(task_.result_index, entry->body))
+    {
+      return true;
+    }
+
+    // a redirect to the same page is requested
+    if (result_at(task_.result_index).artist_url == url)
+    {
+      return false;
+    }
+
+    // the redirected page may also be cached
+    return cache_read(conn_, task_);
+  }
+
+  // a cache entry that can not be decoded is requested again
+  try
+  {
+    page_decode(_inflate, entry->encoding, entry->body, _page);
+  }
+  catch (std::exception const& /*e*/)
+  {
+    return false;
+  }
+
+  _scan.clear();
+  handle_page(_it, _extract, _page, _scan);
+
+  if (_scan.matches.empty() && task_.page_count == 1)
+  {
+    return false;
+  }
+
+  // the scan keeps a spare vector in place of the one passed on
+  auto& page = result_at(task_.result_index).pages[task_.page_count];
+  page.matches = _match_pool.take();
+  std::swap(page.matches, _scan.matches);
+  page.done = true;
+  handle_results(conn_, task_.result_index);
+
+  if (finished())
+  {
+    http_close();
+  }
+
+  return true;
+}
+
+bool App::result_redirect(std::size_t const index_, std::string const& location_)
+{
+  auto& result = result_at(index_);
+
+  auto const redirect = String::match(location_, _rx_redirect);
+
+  if (! redirect)
+  {
+    http_close("invalid redirect URL (" + location_ + ")");
+
+    return false;
+  }
+
+  // concurrent pages of the same artist share one redirect
+  if (redirect->at(1) != result.artist_url)
+  {
+    if (result.redirect_count >= _redirect_total)
+    {
+      http_close("redirect limit reached (" + std::to_string(_redirect_total) + ")");
+
+      return false;
+    }
+
+    ++result.redirect_count;
+
+    // the next request for this name skips the redirect
+    _cache.alias(result.artist_key, redirect->at(1));
+
+    // an artist reached under another name is only crawled once
+    bool const visited {_depth &&
+      String::lowercase(redirect->at(1)) != String::lowercase(result.artist_url) &&
+      ! _visited.insert(String::lowercase(redirect->at(1))).second};
+
+    result.artist_url = redirect->at(1);
+    result.artist = _rp_artist(Belle::Util::url_decode(result.artist_url));
+    result.artist_key = OB::Text::fold_key(result.artist);
+
+    if (visited)
+    {
+      result.done = true;
+      print_ready();
+
+      if (finished())
+      {
+        http_close();
+      }
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void App::page_decode(Belle::Util::Inflate& inflate_, std::string const& encoding_, std::string& body_, std::string& page_) const
+{
+  if (encoding_ == "gzip" || encoding_ == "deflate")
+  {
+    inflate_.decode(body_, page_);
+
+    return;
+  }
+
+  std::swap(page_, body_);
+}
+
+Names::Id App::name_id(std::string_view const name_)
+{
+  auto const [id, inserted] = _names.insert(name_);
+
+  // the caseless key is found once for each name,
+  // a key is its own key
+  if (inserted)
+  {
+    _names_key.emplace_back(static_cast<Names::Id>(id));
+
+    auto const key = _names.insert(OB::Text::fold_key(name_));
+
+    if (key.second)
+    {
+      _names_key.emplace_back(static_cast<Names::Id>(key.first));
+    }
+
+    _names_key.at(id) = static_cast<Names::Id>(key.first);
+  }
+
+  return static_cast<Names::Id>(id);
+}
+
+void App::names_trim()
+{
+  // trimmed once the pool has doubled since it was last trimmed,
+  // so the pool stays bounded by the results not yet printed
+  if (_names.size() < _names_trim)
+  {
+    return;
+  }
+
+  // the old pool holds the names until they are stored in the new one
+  auto const names = std::move(_names);
+  _names = Names();
+  _names_key.clear();
+
+  for (auto& result : _results)
+  {
+    for (auto& id : result.match)
+    {
+      id = name_id(names.at(id));
+    }
+  }
+
+  _names_trim = std::max(_names_min, _names.size() * 2);
+}
+
+bool App::handle_match(Scan& scan_, std::string_view const match_)
+{
+  // at most '_match_total' artists of a page are already matched
+  // and one is the artist itself, the page is scanned only until
+  // enough distinct artists are found to fill the remainder,
+  // counted by caseless key as the matches are merged
+  auto const limit = _match_total * 2 + 1;
+  auto const capacity = scan_.matches.capacity();
+
+  scan_.artist = match_;
+
+  if (auto const cached = scan_.decoded.find(scan_.artist);
+    cached != scan_.decoded.end())
+  {
+    scan_.matches.emplace_back(Similar{cached->second, scan_.artist});
+    _match_pool.count(capacity, scan_.matches);
+
+    return true;
+  }
+
+  // the href is HTML text holding a url, so its character references
+  // are decoded before the percent-encoding
+  scan_.url.clear();
+  String::html_decode(scan_.artist, scan_.url);
+  scan_.buffer.clear();
+  Belle::Util::url_decode(scan_.url, scan_.buffer);
+
+  auto const decoded = _rp_artist(scan_.buffer);
+  scan_.decoded.emplace(scan_.artist, decoded);
+  scan_.matches.emplace_back(Similar{decoded, scan_.artist});
+  _match_pool.count(capacity, scan_.matches);
+
+  if (scan_.distinct.emplace(OB::Text::fold_key(decoded)).second && scan_.distinct.size() >= limit)
+  {
+    scan_.full = true;
+  }
+
+  return ! scan_.full;
+}
+
+void App::handle_page(OB::Text::Regex& it_, Extract& extract_, std::string_view const page_, Scan& scan_)
+{
+  if (_extract_icu)
+  {
+    for (auto const& match : it_.find(_rx_artist, page_))
+    {
+      if (! handle_match(scan_, match.group(0)))
+      {
+        break;
+      }
+    }
+
+    return;
+  }
+
+  extract_.feed(page_, [&](std::string_view const match_) {
+    return handle_match(scan_, match_);
+  });
+  extract_.reset();
+}
+
+void App::page_merge(Page& page_, std::vector<Similar>& matches_)
+{
+  // an empty page takes the vector, its own is given back in its place
+  if (page_.matches.empty())
+  {
+    std::swap(page_.matches, matches_);
+
+    return;
+  }
+
+  auto const capacity = page_.matches.capacity();
+  page_.matches.insert(page_.matches.end(), std::make_move_iterator(matches_.begin()),
+    std::make_move_iterator(matches_.end()));
+  _match_pool.count(capacity, page_.matches);
+}
+
+void App::handle_results(Conn& conn_, std::size_t const index_)
+{
+  auto& result = result_at(index_);
+
+  // merge the fetched pages in page order,
+  // the current page as far as it has been read
+  for (auto page = result.pages.find(result.page_count);
+    page != result.pages.end() && ! result.done;
+    page = result.pages.find(result.page_count))
+  {
+    auto const& matches = page->second.matches;
+
+    for (; result.page_merged < matches.size(); ++result.page_merged)
+    {
+      auto const& similar = matches.at(result.page_merged);
+      auto const id = name_id(similar.artist);
+      auto const key = _names_key.at(id);
+
+      if (similar.artist.at(0) != ' ' && _names.at(key) == result.artist_key)
+      {
+        continue;
+      }
+
+      // case variants of a match are the same match
+      if (std::none_of(result.match.begin(), result.match.end(),
+        [&](auto const match_) { return _names_key.at(match_) == key; }))
+      {
+        result.match.emplace_back(id);
+
+        // an accepted match teaches the alias index its canonical url,
+        // so a later request for the name skips the redirect
+        if (_cache.write())
+        {
+          if (auto name = std::string(_names.at(key)); ! _cache.alias_known(name))
+          {
+            _cache.alias(name, String::html_decode(similar.artist_url));
+          }
+        }
+
+        if (_depth)
+        {
+          result.index_url.emplace_back(similar.artist_url);
+        }
+
+        update_progress(conn_, index_);
+
+        if (result.match.size() >= _match_total)
+        {
+          break;
+        }
+      }
+    }
+
+    if (! page->second.done && result.match.size() < _match_total)
+    {
+      break;
+    }
+
+    // an empty page past the first marks the end of the list
+    bool const last {matches.empty()};
+
+    _match_pool.give(std::move(page->second.matches));
+    result.pages.erase(page);
+    result.page_merged = 0;
+    ++result.page_count;
+
+    if (last || result.match.size() >= _match_total || result.page_count > _page_total)
+    {
+      result.done = true;
+
+      for (auto& rest : result.pages)
+      {
+        _match_pool.give(std::move(rest.second.matches));
+      }
+
+      result.pages.clear();
+    }
+  }
+
+  if (result.done || _stream)
+  {
+    print_ready();
+  }
+}
+
+void App::crawl(Result const& result_)
+{
+  if (result_.depth + 1 >= _depth)
+  {
+    return;
+  }
+
+  // matches are queued in print order, keeping the crawl breadth first
+  for (std::size_t i = 0; i < result_.match.size(); ++i)
+  {
+    auto url = String::html_decode(result_.index_url.at(i));
+
+    if (_visited.insert(String::lowercase(url)).second)
+    {
+      _frontier.emplace_back(Pending{std::string(_names.at(result_.match.at(i))), std::move(url), result_.depth + 1});
+    }
+  }
+}
+
+void App::print_ready()
+{
+  // results are printed in input order as each one completes,
+  // when streaming, the matches of the next result to print
+  // are printed as they are accepted
+  while (_result_print < _result_next)
+  {
+    auto& result = result_at(_result_print);
+
+    if (! result.done && ! _stream)
+    {
+      return;
+    }
+
+    // crawled results are printed as edges without an artist line
+    if (! result.started)
+    {
+      result.started = true;
+
+      if (! _depth)
+      {
+        print_artist(_result_print);
+      }
+    }
+
+    if (result.printed < result.match.size() || result.done)
+    {
+      print_results(_result_print, result.printed);
+      result.printed = result.match.size();
+    }
+
+    if (! result.done)
+    {
+      return;
+    }
+
+    crawl(result);
+
+    // printed results are freed, along with the names only they used
+    _results.pop_front();
+    ++_result_print;
+    names_trim();
+  }
+}
+
+void App::print_stats() const
+{
+  std::size_t responses {0};
+  std::size_t allocations {0};
+  std::size_t resumed {0};
+  std::size_t full {0};
+
+  for (auto const& conn : _conns)
+  {
+    responses += conn.http.responses();
+    allocations += conn.http.allocations();
+    resumed += conn.http.handshakes_resumed();
+    full += conn.http.handshakes_full();
+  }
+
+  std::cerr
+  << "responses: " << responses << "\n"
+  << "read allocations: " << allocations << "\n"
+  << "match vector growths: " << _match_pool.growths << "\n"
+  << "tls handshakes resumed: " << resumed << "\n"
+  << "tls handshakes full: " << full << "\n"
+  << "dns lookups: " << _dns_cache->lookups() << "\n";
+}
+
+void App::print_artist(std::size_t const index_) const
+{
+  if (_progress)
+  {
+    std::cerr
+    << aec::cr
+    << aec::erase_line;
+  }
+
+  auto const& result = result_at(index_);
+
+  if (_color)
+  {
+    std::cout
+    << aec::bold
+    << aec::fg_magenta
+    << result.artist
+    << aec::clear
+    << aec::nl
+    << std::flush;
+  }
+  else
+  {
+    std::cout
+    << result.artist
+    << aec::nl
+    << std::flush;
+  }
+}
+
+void App::print_results(std::size_t const index_, std::size_t const begin_) const
+{
+  if (_progress)
+  {
+    std::cerr
+    << aec::cr
+    << aec::erase_line;
+  }
+
+  auto const& result = result_at(index_);
+
+  if (result.match.size())
+  {
+    // matches from begin_ onward have not been printed yet
+    for (auto i = begin_; i < result.match.size(); ++i)
+    {
+      auto const artist = _names.at(result.match.at(i));
+
+      if (_depth)
+      {
+        // crawled results are printed as 'artist -> similar' edges
+        if (_color)
+        {
+          std::cout
+          << aec::bold
+          << aec::fg_magenta
+          << result.artist
+          << aec::fg_white
+          << " -> "
+          << artist
+          << aec::clear
+          << aec::nl;
+        }
+        else
+        {
+          std::cout
+          << result.artist
+          << " -> "
+          << artist
+          << aec::nl;
+        }
+      }
+      else if (_color)
       {
         std::cout
         << aec::bold
         << aec::fg_white
-        << *artist
+        << artist
         << aec::clear
         << aec::nl;
       }
       else
       {
         std::cout
-        << *artist
+        << artist
         << aec::nl;
       }
     }
 
-    if (_result_index + 1 < _results.size())
+    if (! _depth && result.done && (index_ + 1 < _result_next || _artists.size()))
     {
       std::cout
       << aec::nl;
@@ -538,6 +1637,54 @@ void App::print_results() const
   }
 }
 
+void App::input_read()
+{
+  // keep one artist read ahead of the results
+  std::string line;
+
+  while (_input && _artists.empty() && std::getline(*_input, line))
+  {
+    if (line = String::trim(line); line.size())
+    {
+      _artists.emplace_back(Pending{std::move(line), {}, 0});
+    }
+  }
+}
+
+App::Result& App::result_at(std::size_t const index_)
+{
+  return _results.at(index_ - _result_print);
+}
+
+App::Result const& App::result_at(std::size_t const index_) const
+{
+  return _results.at(index_ - _result_print);
+}
+
+bool App::result_done(std::size_t const index_) const
+{
+  return index_ < _result_print || result_at(index_).done;
+}
+
+bool App::finished() const
+{
+  return _result_print == _result_next && _artists.empty() && _frontier.empty();
+}
+
+std::string const& App::status_string()
+{
+  // report the connection fetching the next result to print
+  for (auto& conn : _conns)
+  {
+    if (conn.tasks.size() && conn.tasks.front().result_index == _result_print)
+    {
+      return conn.http.status_string();
+    }
+  }
+
+  return _conns.front().http.status_string();
+}
+
 std::string App::artist_target(std::string const& artist_) const
 {
   return "/music/" + artist_ + "/+similar";
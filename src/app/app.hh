@@ -46,6 +46,10 @@ SOFTWARE.
 #ifndef APP_HH
 #define APP_HH
 
+#include "app/cache.hh"
+#include "app/extract.hh"
+#include "app/names.hh"
+
 #include "ob/text.hh"
 #include "ob/term.hh"
 #include "ob/belle.hh"
@@ -55,15 +59,24 @@ SOFTWARE.
 
 #include <cstddef>
 
-#include <set>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <deque>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <chrono>
 #include <utility>
+#include <fstream>
 #include <sstream>
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace Belle = OB::Belle;
 namespace String = OB::String;
@@ -83,33 +96,321 @@ public:
   App& operator=(App const&) = delete;
 
   void artists(std::vector<std::string> const& val_, bool const ignore_case_ = false);
+  void burst(std::size_t const val_);
+  void cache(std::string const& val_);
+  void cache_ttl(std::size_t const val_);
   void color(bool const val_);
   void count(std::size_t const val_);
+  void depth(std::size_t const val_);
+  void dns_ttl(std::size_t const val_);
+  void extract(std::string const& val_);
+  void fast_open(bool const val_);
   void headers(std::vector<std::string> const& val_);
+  void input(std::string const& val_);
+  void jobs(std::size_t const val_);
+  void keepalive(std::size_t const val_);
+  void keepalive_interval(std::size_t const val_);
+  void keepalive_probes(std::size_t const val_);
+  void nodelay(bool const val_);
+  void pages(std::size_t const val_);
+  void pipeline(std::size_t const val_);
   void progress(bool const val_);
+  void rate(std::size_t const val_);
+  void recv_buffer(std::size_t const val_);
+  void send_buffer(std::size_t const val_);
+  void stats(bool const val_);
+  void stream(bool const val_);
+  void threads(std::size_t const val_);
 
   void run();
 
 private:
 
+  struct Result;
+
+  // page request
+  struct Task
+  {
+    // index position in the results of the artist being fetched
+    std::size_t result_index {0};
+
+    // page number being fetched
+    std::size_t page_count {0};
+  }; // struct Task
+
+  // similar artist found on a page
+  struct Similar
+  {
+    // artist
+    std::string artist;
+
+    // artist formatted for use in url, as found in the page
+    std::string artist_url;
+  }; // struct Similar
+
+  // artist waiting to be started
+  struct Pending
+  {
+    // artist
+    std::string artist;
+
+    // artist formatted for use in url, empty for a seed artist
+    std::string artist_url;
+
+    // crawl depth, zero for a seed artist
+    std::size_t depth {0};
+  }; // struct Pending
+
+  // similar artists found in a page as it is read
+  struct Scan
+  {
+    // ready for the next page, keeping the storage
+    void clear()
+    {
+      decoded.clear();
+      distinct.clear();
+      artist.clear();
+      url.clear();
+      buffer.clear();
+      matches.clear();
+      posted = 0;
+      full = false;
+    }
+
+    // artist formatted for use in url, as found in the page, to artist
+    std::unordered_map<std::string, std::string> decoded;
+
+    // caseless keys of the distinct artists found
+    std::unordered_set<std::string> distinct;
+
+    // buffer for the artist being decoded
+    std::string artist;
+
+    // buffer for the artist url with its character references decoded
+    std::string url;
+
+    // buffer for the url decoded artist
+    std::string buffer;
+
+    // similar artist matches in page order
+    std::vector<Similar> matches;
+
+    // number of matches passed to the app strand before the page completed
+    std::size_t posted {0};
+
+    // when true, enough artists have been found and the rest of the page is skipped
+    bool full {false};
+  }; // struct Scan
+
+  // spare match vectors, shared by the connection strands and the app strand,
+  // a vector taken is given back once its matches are merged,
+  // so that match storage is reused from page to page
+  struct Match_Pool
+  {
+    // takes a spare vector, or an empty one when there are none
+    std::vector<Similar> take()
+    {
+      std::lock_guard<std::mutex> lock {mutex};
+
+      if (spare.empty())
+      {
+        return {};
+      }
+
+      auto matches = std::move(spare.back());
+      spare.pop_back();
+
+      return matches;
+    }
+
+    // gives back a vector, keeping its storage
+    void give(std::vector<Similar>&& matches_)
+    {
+      if (! matches_.capacity())
+      {
+        return;
+      }
+
+      matches_.clear();
+
+      std::lock_guard<std::mutex> lock {mutex};
+      spare.emplace_back(std::move(matches_));
+    }
+
+    // counts a vector whose storage grew past the capacity it had
+    void count(std::size_t const capacity_, std::vector<Similar> const& matches_)
+    {
+      if (matches_.capacity() > capacity_)
+      {
+        ++growths;
+      }
+    }
+
+    std::mutex mutex;
+
+    // vectors given back
+    std::vector<std::vector<Similar>> spare;
+
+    // number of times a match vector grew its storage, read from any thread
+    std::atomic<std::size_t> growths {0};
+  }; // struct Match_Pool
+
+  // fetched page waiting to be merged
+  struct Page
+  {
+    // similar artist matches in page order, a page being read is merged as it grows
+    std::vector<Similar> matches;
+
+    // when true, the whole page has been read
+    bool done {false};
+  }; // struct Page
+
+  // response fields passed from a connection to the app strand
+  struct Reply
+  {
+    // HTTP status code
+    int status {0};
+
+    // HTTP reason phrase
+    std::string reason;
+
+    // HTTP location header value
+    std::string location;
+
+    // when false, the peer closes the connection after the response
+    bool keep_alive {true};
+
+    // when true, the response body was empty
+    bool empty {false};
+
+    // decoded similar artist matches in page order
+    std::vector<Similar> matches;
+
+    // when true, the earlier matches of the page were passed on as it was read
+    bool partial {false};
+  }; // struct Reply
+
+  // pooled connection state
+  struct Conn
+  {
+    Conn(Belle::io& io_, std::string const& address_, unsigned short const port_) :
+      http {io_, address_, port_, true}
+    {
+    }
+
+    // HTTP client
+    Belle::Client::Http http;
+
+    // HTTP request, reused for each subsequent request
+    Belle::Request req;
+
+    // page requests in the order written
+    std::deque<Task> tasks;
+
+    // number of page requests written
+    std::size_t written {0};
+
+    // buffer for HTTP response body, used on the connection's strand
+    std::string page;
+
+    // number of requests written, identifies the response being read
+    std::size_t request_id {0};
+
+    // request of the response body being scanned, used on the connection's strand
+    std::size_t scan_id {0};
+
+    // size of the response body being scanned, used on the connection's strand
+    std::size_t scan_size {0};
+
+    // similar artists found in the response body being scanned,
+    // used on the connection's strand
+    Scan scan;
+
+    // inflates the response body as it is read, used on the connection's strand
+    Belle::Util::Inflate inflate;
+
+    // regex iterator, used on the connection's strand
+    OB::Text::Regex it;
+
+    // artist url extractor, used on the connection's strand
+    Extract extract;
+
+    // when true, the socket is being closed to be reopened
+    bool reconnect {false};
+
+    // number of reconnects since the last response
+    std::size_t reconnect_count {0};
+
+    // when true, the socket is open
+    bool open {false};
+
+    // when true, the connection has finished
+    bool closed {false};
+
+    // when true, the connection is waiting on the rate limiter
+    bool waiting {false};
+
+    // when true, the connection has been run, connections are only
+    // run once there is a request that could not be served from the cache
+    bool started {false};
+  }; // struct Conn
+
+  using Conns = std::deque<Conn>;
+
   void do_timer();
   void on_timer(Belle::error_code const& ec_);
 
-  void update_wait();
-  void update_progress();
+  void update_progress(Conn& conn_, std::size_t const index_);
 
   void signal_init();
 
   void http_init();
-  void http_init_request();
-  void http_next();
-  void http_redirect(Belle::Client::Http::Session_Ctx const& ctx_);
+  void http_init_conn(Conn& conn_);
+  void http_init_request(Conn& conn_);
+  bool http_assign(Conn& conn_);
+  void http_start(Conn& conn_);
+  void http_wake();
+  void http_wait(Conn& conn_);
+  void http_next(Conn& conn_);
+  void http_data(Conn& conn_, Belle::Client::Http::Session_Ctx& ctx_, Task const& task_, std::size_t const id_, std::string_view const data_);
+  void http_partial(Conn& conn_, Task const& task_, std::vector<Similar>& matches_);
+  Reply http_parse(Conn& conn_, Belle::Client::Http::Session_Ctx& ctx_, std::string const& key_, std::size_t const id_);
+  void http_read(Conn& conn_, Task const& task_, Reply& reply_);
+  void http_reopen(Conn& conn_);
+  void http_reconnect(Conn& conn_, bool const failed_ = false);
+  void http_redirect(Conn& conn_, Task const& task_, std::string const& location_);
   void http_close(std::string const& msg_ = {});
+  void http_closed(Conn& conn_);
 
-  void handle_results();
+  std::optional<Task> task_next();
+  std::string task_key(Task const& task_) const;
 
-  void print_artist() const;
-  void print_results() const;
+  bool cache_read(Conn& conn_, Task const& task_);
+
+  bool result_redirect(std::size_t const index_, std::string const& location_);
+
+  void page_decode(Belle::Util::Inflate& inflate_, std::string const& encoding_, std::string& body_, std::string& page_) const;
+
+  Names::Id name_id(std::string_view const name_);
+  void names_trim();
+
+  bool handle_match(Scan& scan_, std::string_view const match_);
+  void handle_page(OB::Text::Regex& it_, Extract& extract_, std::string_view const page_, Scan& scan_);
+  void page_merge(Page& page_, std::vector<Similar>& matches_);
+  void handle_results(Conn& conn_, std::size_t const index_);
+
+  void crawl(Result const& result_);
+
+  void print_ready();
+  void print_stats() const;
+  void print_artist(std::size_t const index_) const;
+  void print_results(std::size_t const index_, std::size_t const begin_) const;
+  void input_read();
+  Result& result_at(std::size_t const index_);
+  Result const& result_at(std::size_t const index_) const;
+  bool result_done(std::size_t const index_) const;
+  bool finished() const;
+  std::string const& status_string();
   std::string artist_target(std::string const& artist_) const;
 
   // HTTP connect port
@@ -118,8 +419,12 @@ private:
   // HTTP connect address
   std::string const _address {"www.last.fm"};
 
-  // artist regex
-  std::string const _rx_artist {"href=\"/music/([^/]+?)\"\\s+"};
+  // artist regex, compiled once and shared by the connections
+  OB::Text::Regex_Pattern const _rx_artist {"href=\"/music/([^/]+?)\"\\s+"};
+
+  // decodes the '+' left escaped in a url decoded artist,
+  // shared by the connections
+  String::Replace const _rp_artist {{{"%2B", "+"}}};
 
   // redirect regex
   std::regex const _rx_redirect {"^https://www.last.fm/music/(.+?)/\\+similar.*$", std::regex::icase};
@@ -127,26 +432,29 @@ private:
   // total number of redirects to follow per artist
   std::size_t const _redirect_total {3};
 
+  // total number of reconnects per connection without a response
+  std::size_t const _reconnect_total {3};
+
   // total number of pages to request per artist
   std::size_t const _page_total {10};
 
   // update / timer interval
   std::chrono::milliseconds const _interval {100};
 
-  // total request wait time
-  std::chrono::milliseconds const _wait_total {1000};
-
   // progress output char values
   std::string const _progress_str {"-\\|/"};
 
+  // smallest size of the names pool that is trimmed
+  std::size_t const _names_min {4096};
+
   // artist result
   struct Result
   {
     // artist
     std::string artist;
 
-    // artist in lowercase
-    std::string artist_lowercase;
+    // caseless key of the artist, see 'OB::Text::fold_key'
+    std::string artist_key;
 
     // artist formatted for use in url
     std::string artist_url;
@@ -154,30 +462,131 @@ private:
     // current page number
     std::size_t page_count {1};
 
+    // next page number to request
+    std::size_t page_next {1};
+
+    // fetched pages waiting to be merged in page order
+    std::map<std::size_t, Page> pages;
+
+    // number of matches of the current page merged
+    std::size_t page_merged {0};
+
     // number of redirects followed
     std::size_t redirect_count {0};
 
-    // similar artist matches
-    std::set<std::string> match;
+    // when true, all pages have been fetched
+    bool done {false};
+
+    // when true, the artist has been printed
+    bool started {false};
+
+    // number of matches printed
+    std::size_t printed {0};
 
-    // insert ordered iterators to similar artist matches
-    std::vector<decltype(match)::const_iterator> index;
+    // similar artist matches in insertion order, as ids of the names pool
+    std::vector<Names::Id> match;
+
+    // similar artist matches formatted for use in url, in match order,
+    // only kept when crawling
+    std::vector<std::string> index_url;
+
+    // crawl depth, zero for a seed artist
+    std::size_t depth {0};
   }; // struct Result
 
-  using Results = std::vector<Result>;
+  // results from the next to print up to the next to start,
+  // freed once printed
+  using Results = std::deque<Result>;
 
   // artist results
   Results _results;
 
+  // seed artists waiting to be started
+  std::deque<Pending> _artists;
+
+  // crawled artists waiting to be started, after the seed artists
+  std::deque<Pending> _frontier;
+
+  // lowercase url of each artist started or queued when crawling
+  Names _visited;
+
+  // artist names seen by the results not yet printed, and their caseless keys,
+  // stored once, the names of printed results are dropped as the pool grows,
+  // used on the app strand
+  Names _names;
+
+  // id of the caseless key of each name in the names pool
+  std::vector<Names::Id> _names_key;
+
+  // size of the names pool at which it is next trimmed
+  std::size_t _names_trim {_names_min};
+
+  // number of levels of similar artists to crawl, zero disables crawling
+  std::size_t _depth {0};
+
+  // artist input stream, read one line at a time as artists are started
+  std::istream* _input {nullptr};
+
+  // artist input file
+  std::ifstream _input_file;
+
+  // when true, artists are converted to titlecase
+  bool _ignore_case {false};
+
+  // when true, artist urls are found with the ICU regex '_rx_artist',
+  // otherwise with the equivalent extractor
+  bool _extract_icu {false};
+
   // when true, use color in output
   bool _color {false};
 
+  // when true, response, buffer growth, handshake and lookup counts
+  // are output to stderr once finished
+  bool _stats {false};
+
+  // when true, requests are sent at once instead of coalescing small writes
+  bool _nodelay {false};
+
+  // when true, connections send their first bytes with the connection request
+  bool _fast_open {false};
+
+  // socket send buffer size in bytes, zero keeps the system default
+  std::size_t _send_buffer {0};
+
+  // socket receive buffer size in bytes, zero keeps the system default
+  std::size_t _recv_buffer {0};
+
+  // seconds idle before the first keepalive probe, zero disables keepalive
+  std::size_t _keepalive {0};
+
+  // seconds between keepalive probes, zero keeps the system default
+  std::size_t _keepalive_interval {0};
+
+  // number of unanswered keepalive probes before a connection is dropped,
+  // zero keeps the system default
+  std::size_t _keepalive_probes {0};
+
   // when true, progress is output to stderr
   bool _progress {false};
 
+  // when true, matches are printed as they are accepted
+  bool _stream {false};
+
   // total number of matches to find per artist
   std::size_t _match_total {0};
 
+  // number of artists to fetch concurrently
+  std::size_t _jobs {1};
+
+  // number of pages to request concurrently for each artist
+  std::size_t _pages {1};
+
+  // number of requests to pipeline on each connection
+  std::size_t _pipeline {1};
+
+  // number of threads to run the io context on
+  std::size_t _threads {1};
+
   // default HTTP request headers to use
   std::unordered_map<std::string, std::string> _headers {
     {"host", _address},
@@ -191,41 +600,65 @@ private:
     {"user-agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/75.0.3770.142 Safari/537.36"},
   };
 
-  // when true, reconnect socket if closed
-  bool _reconnect {false};
+  // index position of the next result to assign to a connection
+  std::size_t _result_next {0};
 
-  // HTTP response status code
-  int _http_status {0};
-
-  // current index position in the results
-  std::size_t _result_index {0};
-
-  // current request wait time
-  std::chrono::milliseconds _wait_count {0};
+  // index position of the next result to print, the front of '_results'
+  std::size_t _result_print {0};
 
   // current index position in the progress string
   std::size_t _progress_index {0};
 
-  // buffer for HTTP response body
-  std::string _page;
-
   // HTTP error message
   std::string _http_reason;
 
-  // regex iterator
-  OB::Text::Regex _it;
+  // when true, the run has ended and the connections are closing
+  bool _closing {false};
 
-  // HTTP request, reused for each subsequent request
-  Belle::Request _req;
+  // io context, the thread count is not known at construction
+  Belle::io _io {};
 
-  // io context
-  Belle::io _io {1};
+  // serializes access to the app state across threads
+  Belle::net::strand<Belle::io::executor_type> _strand {_io.get_executor()};
 
   // capture and handle signals
   Belle::Signal _sig {_io};
 
-  // HTTP client
-  Belle::Client::Http _http {_io, _address, _port, true};
+  // request rate limiter, shared by all connections to a host
+  Belle::Limiter _limiter {_io};
+
+  // HTTP response cache
+  Cache _cache;
+
+  // TLS sessions shared by the connections, so that reconnects and new
+  // connections resume instead of doing a full handshake,
+  // persisted alongside the response cache
+  std::shared_ptr<Belle::Client::Tls_Cache> const _tls_cache {std::make_shared<Belle::Client::Tls_Cache>()};
+
+  // host lookups shared by the connections, so that opening the
+  // connections and reconnecting costs one lookup per ttl
+  std::shared_ptr<Belle::Client::Dns_Cache> const _dns_cache {std::make_shared<Belle::Client::Dns_Cache>()};
+
+  // buffer for a cached response body, used on the app strand
+  std::string _page;
+
+  // inflate stream for cached responses, used on the app strand
+  Belle::Util::Inflate _inflate;
+
+  // regex iterator for cached responses, used on the app strand
+  OB::Text::Regex _it;
+
+  // artist url extractor for cached responses, used on the app strand
+  Extract _extract;
+
+  // similar artists found in a cached response, used on the app strand
+  Scan _scan;
+
+  // match vectors reused by the connections and the app strand
+  Match_Pool _match_pool;
+
+  // HTTP connection pool
+  Conns _conns;
 
   // timer for progress output
   Belle::net::high_resolution_timer _timer {_io, _interval};
@@ -0,0 +1,405 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "app/cache.hh"
+
+#include <cstdlib>
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+void Cache::mode(Mode const val_)
+{
+  _mode = val_;
+}
+
+void Cache::ttl(std::chrono::seconds const val_)
+{
+  _ttl = val_;
+}
+
+void Cache::init()
+{
+  if (_mode == Mode::off)
+  {
+    return;
+  }
+
+  // follow the XDG base directory specification
+  if (char const* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+  {
+    _dir = std::filesystem::path(xdg) / "lssa";
+  }
+  else if (char const* home = std::getenv("HOME"); home && *home)
+  {
+    _dir = std::filesystem::path(home) / ".cache" / "lssa";
+  }
+  else
+  {
+    throw std::runtime_error("could not find the cache directory, set XDG_CACHE_HOME or HOME");
+  }
+
+  if (_mode == Mode::readwrite)
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(_dir, ec);
+
+    if (ec)
+    {
+      throw std::runtime_error("could not create the cache directory '" + _dir.string() + "'");
+    }
+  }
+
+  // one 'artist<tab>url' pair per line, from least to most recently used
+  std::ifstream is {_dir / "aliases"};
+  std::string line;
+
+  while (std::getline(is, line))
+  {
+    if (auto const tab = line.find('\t'); tab != std::string::npos && tab + 1 < line.size())
+    {
+      _alias.insert_or_assign(line.substr(0, tab), Alias{line.substr(tab + 1), ++_alias_used});
+    }
+  }
+}
+
+bool Cache::read() const
+{
+  return _mode != Mode::off;
+}
+
+bool Cache::write() const
+{
+  return _mode == Mode::readwrite;
+}
+
+std::optional<Cache::Entry> Cache::get(std::string const& key_) const
+{
+  if (! read())
+  {
+    return {};
+  }
+
+  std::ifstream is {file(key_), std::ios::binary};
+
+  if (! is)
+  {
+    return {};
+  }
+
+  // header line of 'time status encoding', followed by the key and the body
+  std::string line;
+  std::string key;
+  std::int64_t time {0};
+  Entry entry;
+
+  if (! std::getline(is, line) || ! std::getline(is, key) || key != key_)
+  {
+    return {};
+  }
+
+  std::istringstream ss {line};
+
+  if (! (ss >> time >> entry.status))
+  {
+    return {};
+  }
+
+  ss >> entry.encoding;
+
+  auto const age = std::chrono::system_clock::now() -
+    std::chrono::system_clock::time_point(std::chrono::seconds(time));
+
+  if (age > _ttl)
+  {
+    return {};
+  }
+
+  entry.body.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+
+  return entry;
+}
+
+void Cache::put(std::string const& key_, Entry const& entry_) const
+{
+  if (! write())
+  {
+    return;
+  }
+
+  static std::atomic<std::size_t> count {0};
+
+  auto const path = file(key_);
+
+  // write to a unique temporary file, then rename it into place,
+  // readers never see a partial entry
+  std::ostringstream tmp;
+  tmp << path.string() << ".tmp." << std::this_thread::get_id() << "." << count++;
+
+  {
+    std::ofstream os {tmp.str(), std::ios::binary | std::ios::trunc};
+
+    if (! os)
+    {
+      return;
+    }
+
+    os
+    << std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count()
+    << " "
+    << entry_.status
+    << " "
+    << entry_.encoding
+    << "\n"
+    << key_
+    << "\n";
+
+    os.write(entry_.body.data(), static_cast<std::streamsize>(entry_.body.size()));
+
+    if (! os)
+    {
+      os.close();
+      std::error_code ec;
+      std::filesystem::remove(tmp.str(), ec);
+
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp.str(), path, ec);
+
+  if (ec)
+  {
+    std::filesystem::remove(tmp.str(), ec);
+  }
+}
+
+std::optional<std::string> Cache::alias(std::string const& key_)
+{
+  if (! read())
+  {
+    return {};
+  }
+
+  if (auto const it = _alias.find(key_); it != _alias.end())
+  {
+    // a used alias is kept over the others when the index is trimmed
+    it->second.used = ++_alias_used;
+    _alias_changed = true;
+
+    return it->second.url;
+  }
+
+  return {};
+}
+
+bool Cache::alias_known(std::string const& key_) const
+{
+  return _alias.find(key_) != _alias.end();
+}
+
+void Cache::alias(std::string const& key_, std::string const& val_)
+{
+  if (! write() || key_.empty() || val_.empty() ||
+    key_.find_first_of("\t\n") != std::string::npos ||
+    val_.find_first_of("\t\n") != std::string::npos)
+  {
+    return;
+  }
+
+  _alias.insert_or_assign(key_, Alias{val_, ++_alias_used});
+  _alias_changed = true;
+}
+
+void Cache::alias_save()
+{
+  if (! write() || ! _alias_changed)
+  {
+    return;
+  }
+
+  // the most recently used aliases are kept, written in order of use
+  std::vector<std::unordered_map<std::string, Alias>::const_iterator> order;
+  order.reserve(_alias.size());
+
+  for (auto it = _alias.cbegin(); it != _alias.cend(); ++it)
+  {
+    order.emplace_back(it);
+  }
+
+  std::sort(order.begin(), order.end(),
+    [](auto const& lhs, auto const& rhs) { return lhs->second.used < rhs->second.used; });
+
+  if (order.size() > _alias_max)
+  {
+    for (auto it = order.begin(); it != order.end() - static_cast<std::ptrdiff_t>(_alias_max); ++it)
+    {
+      _alias.erase(*it);
+    }
+
+    order.erase(order.begin(), order.end() - static_cast<std::ptrdiff_t>(_alias_max));
+  }
+
+  auto const path = _dir / "aliases";
+  auto const tmp = path.string() + ".tmp";
+
+  {
+    std::ofstream os {tmp, std::ios::trunc};
+
+    if (! os)
+    {
+      return;
+    }
+
+    for (auto const& it : order)
+    {
+      os << it->first << "\t" << it->second.url << "\n";
+    }
+
+    if (! os)
+    {
+      os.close();
+      std::error_code ec;
+      std::filesystem::remove(tmp, ec);
+
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp, path, ec);
+
+  if (ec)
+  {
+    std::filesystem::remove(tmp, ec);
+
+    return;
+  }
+
+  _alias_changed = false;
+}
+
+std::string Cache::tls_load() const
+{
+  if (! read())
+  {
+    return {};
+  }
+
+  std::ifstream is {_dir / "tls", std::ios::binary};
+
+  return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+void Cache::tls_save(std::string const& val_) const
+{
+  if (! write())
+  {
+    return;
+  }
+
+  auto const path = _dir / "tls";
+  auto const tmp = path.string() + ".tmp";
+
+  {
+    std::ofstream os {tmp, std::ios::binary | std::ios::trunc};
+
+    if (! os)
+    {
+      return;
+    }
+
+    // the sessions hold secrets
+    std::error_code ec;
+    std::filesystem::permissions(tmp,
+      std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+      std::filesystem::perm_options::replace, ec);
+
+    os << val_;
+
+    if (ec || ! os)
+    {
+      os.close();
+      std::filesystem::remove(tmp, ec);
+
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp, path, ec);
+
+  if (ec)
+  {
+    std::filesystem::remove(tmp, ec);
+  }
+}
+
+std::filesystem::path Cache::file(std::string_view key_) const
+{
+  // FNV-1a, stable across runs and platforms
+  std::uint64_t hash {0xcbf29ce484222325};
+
+  for (auto const c : key_)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+
+  std::ostringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+
+  return _dir / ss.str();
+}
@@ -0,0 +1,150 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef APP_CACHE_HH
+#define APP_CACHE_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <chrono>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+// on-disk HTTP response cache, one file per key,
+// safe to use from any thread, an alias index of artist names
+// to their canonical url, bounded to the most recently used,
+// used from one thread, and the TLS sessions to resume,
+// kept readable only by the user
+class Cache final
+{
+public:
+
+  enum class Mode
+  {
+    off,
+    read,
+    readwrite,
+  };
+
+  // cached response
+  struct Entry
+  {
+    // HTTP status code
+    int status {0};
+
+    // HTTP content-encoding header value, the body is stored as received
+    std::string encoding;
+
+    // HTTP response body, or the location of a redirect
+    std::string body;
+  }; // struct Entry
+
+  Cache() = default;
+  Cache(Cache&&) = delete;
+  Cache(Cache const&) = delete;
+  ~Cache() = default;
+
+  Cache& operator=(Cache&&) = delete;
+  Cache& operator=(Cache const&) = delete;
+
+  void mode(Mode const val_);
+  void ttl(std::chrono::seconds const val_);
+  void init();
+
+  bool read() const;
+  bool write() const;
+
+  std::optional<Entry> get(std::string const& key_) const;
+  void put(std::string const& key_, Entry const& entry_) const;
+
+  std::optional<std::string> alias(std::string const& key_);
+  bool alias_known(std::string const& key_) const;
+  void alias(std::string const& key_, std::string const& val_);
+  void alias_save();
+
+  std::string tls_load() const;
+  void tls_save(std::string const& val_) const;
+
+private:
+
+  std::filesystem::path file(std::string_view key_) const;
+
+  // cache mode
+  Mode _mode {Mode::off};
+
+  // maximum age of an entry
+  std::chrono::seconds _ttl {std::chrono::hours(24)};
+
+  // cache directory
+  std::filesystem::path _dir;
+
+  // canonical artist url of an alias
+  struct Alias
+  {
+    // canonical artist url
+    std::string url;
+
+    // value of '_alias_used' when the alias was last used or learned
+    std::uint64_t used {0};
+  }; // struct Alias
+
+  // caseless artist key to canonical artist url
+  std::unordered_map<std::string, Alias> _alias;
+
+  // count of alias uses, orders the aliases from least to most recently used
+  std::uint64_t _alias_used {0};
+
+  // maximum number of aliases kept, the least recently used are dropped on save
+  std::size_t _alias_max {10000};
+
+  // when true, the alias index has changed since it was loaded
+  bool _alias_changed {false};
+}; // class Cache
+
+#endif // APP_CACHE_HH
@@ -0,0 +1,222 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "app/extract.hh"
+
+#include <cstring>
+
+#include <algorithm>
+
+namespace
+{
+
+constexpr std::string_view prefix {"href=\"/music/"};
+
+// offset of the first caseless byte, searched for with memchr
+constexpr std::size_t prefix_eq {4};
+
+bool prefix_equal(char const* str_)
+{
+  for (std::size_t i = 0; i < prefix.size(); ++i)
+  {
+    auto c = str_[i];
+
+    if (c >= 'A' && c <= 'Z')
+    {
+      c = static_cast<char>(c + ('a' - 'A'));
+    }
+
+    if (c != prefix[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// returns 1 when a whitespace character starts at pos_, as matched by the
+// regex '\s', 0 when not, and -1 when more input is needed to tell
+int whitespace(std::string_view const buf_, std::size_t const pos_)
+{
+  if (pos_ >= buf_.size())
+  {
+    return -1;
+  }
+
+  auto const byte = [&](std::size_t const i) {
+    return static_cast<unsigned char>(buf_[pos_ + i]);
+  };
+
+  auto const c = byte(0);
+
+  if ((c >= 0x09 && c <= 0x0d) || c == 0x20)
+  {
+    return 1;
+  }
+
+  // U+0085 U+00A0
+  if (c == 0xc2)
+  {
+    if (pos_ + 2 > buf_.size())
+    {
+      return -1;
+    }
+
+    return byte(1) == 0x85 || byte(1) == 0xa0;
+  }
+
+  if (c < 0xe1 || c > 0xe3)
+  {
+    return 0;
+  }
+
+  if (pos_ + 3 > buf_.size())
+  {
+    return -1;
+  }
+
+  auto const c1 = byte(1);
+  auto const c2 = byte(2);
+
+  switch (c)
+  {
+    // U+1680
+    case 0xe1:
+      return c1 == 0x9a && c2 == 0x80;
+
+    // U+2000-U+200A U+2028 U+2029 U+202F U+205F
+    case 0xe2:
+      return (c1 == 0x80 && ((c2 >= 0x80 && c2 <= 0x8a) || c2 == 0xa8 || c2 == 0xa9 || c2 == 0xaf)) ||
+        (c1 == 0x81 && c2 == 0x9f);
+
+    // U+3000
+    case 0xe3:
+      return c1 == 0x80 && c2 == 0x80;
+
+    default:
+      return 0;
+  }
+}
+
+} // namespace
+
+void Extract::reset()
+{
+  _tail.clear();
+}
+
+bool Extract::find(std::string_view const buf_, std::size_t& pos_, std::string_view& val_) const
+{
+  auto const data = buf_.data();
+  auto const size = buf_.size();
+
+  for (auto at = pos_ + prefix_eq; at < size;)
+  {
+    auto const eq = static_cast<char const*>(std::memchr(data + at, '=', size - at));
+
+    if (! eq)
+    {
+      break;
+    }
+
+    auto const begin = static_cast<std::size_t>(eq - data) - prefix_eq;
+    at = begin + prefix_eq + 1;
+
+    if (begin + prefix.size() > size)
+    {
+      pos_ = begin;
+
+      return false;
+    }
+
+    if (! prefix_equal(data + begin))
+    {
+      continue;
+    }
+
+    // at least one character other than '/',
+    // up to the first quote followed by whitespace
+    auto const first = begin + prefix.size();
+    auto i = first;
+
+    for (; i < size && data[i] != '/'; ++i)
+    {
+      if (data[i] != '"' || i == first)
+      {
+        continue;
+      }
+
+      auto const space = whitespace(buf_, i + 1);
+
+      if (space < 0)
+      {
+        pos_ = begin;
+
+        return false;
+      }
+
+      if (space > 0)
+      {
+        val_ = buf_.substr(first, i - first);
+        pos_ = i + 1;
+
+        return true;
+      }
+    }
+
+    if (i == size)
+    {
+      pos_ = begin;
+
+      return false;
+    }
+  }
+
+  // the end of the input may hold the start of the prefix
+  pos_ = std::max(pos_, size > prefix.size() - 1 ? size - (prefix.size() - 1) : std::size_t {0});
+
+  return false;
+}
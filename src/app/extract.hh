@@ -0,0 +1,120 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef APP_EXTRACT_HH
+#define APP_EXTRACT_HH
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+
+// finds the artist url in each 'href="/music/<artist>"' attribute,
+// giving the same results as matching the regex 'href="/music/([^/]+?)"\s+'
+// case insensitively, with the prefix compared as ASCII,
+// input can be given whole or in chunks as it arrives
+class Extract final
+{
+public:
+
+  Extract() = default;
+  Extract(Extract&&) = default;
+  Extract(Extract const&) = default;
+  ~Extract() = default;
+
+  Extract& operator=(Extract&&) = default;
+  Extract& operator=(Extract const&) = default;
+
+  // calls fn_ with each artist url completed by the chunk, the view is only
+  // valid for the call, stops and returns false when fn_ returns false
+  template<typename F>
+  bool feed(std::string_view const chunk_, F&& fn_)
+  {
+    // a match split across chunks is completed from the kept tail
+    bool const tail {! _tail.empty()};
+
+    if (tail)
+    {
+      _tail.append(chunk_);
+    }
+
+    std::string_view const buf {tail ? std::string_view(_tail) : chunk_};
+    std::size_t pos {0};
+    std::string_view val;
+
+    while (find(buf, pos, val))
+    {
+      if (! fn_(val))
+      {
+        reset();
+
+        return false;
+      }
+    }
+
+    if (tail)
+    {
+      _tail.erase(0, pos);
+    }
+    else
+    {
+      _tail.assign(buf.substr(pos));
+    }
+
+    return true;
+  }
+
+  // ready for the next document
+  void reset();
+
+private:
+
+  bool find(std::string_view const buf_, std::size_t& pos_, std::string_view& val_) const;
+
+  // input from the start of an incomplete match
+  std::string _tail;
+}; // class Extract
+
+#endif // APP_EXTRACT_HH
@@ -0,0 +1,167 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "app/names.hh"
+
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+
+// size of the first arena block, doubled for each block after it
+constexpr std::size_t block_min {512};
+constexpr std::size_t block_max {65536};
+
+// number of slots of the first set
+constexpr std::size_t slots_min {16};
+
+} // namespace
+
+std::pair<std::size_t, bool> Names::insert(std::string_view const name_)
+{
+  auto const hash = std::hash<std::string_view>{}(name_);
+
+  if (! _slots.empty())
+  {
+    if (auto const slot = _slots[probe(name_, hash)])
+    {
+      return {slot - 1, false};
+    }
+  }
+
+  if ((_names.size() + 1) * 2 > _slots.size())
+  {
+    rehash(std::max(slots_min, _slots.size() * 2));
+  }
+
+  if (_names.size() >= UINT32_MAX)
+  {
+    throw std::runtime_error("too many names");
+  }
+
+  auto const pos = _names.size();
+  _names.emplace_back(store(name_));
+  _hashes.emplace_back(hash);
+  _slots[probe(name_, hash)] = static_cast<std::uint32_t>(pos + 1);
+
+  return {pos, true};
+}
+
+std::optional<std::size_t> Names::find(std::string_view const name_) const
+{
+  if (_slots.empty())
+  {
+    return {};
+  }
+
+  if (auto const slot = _slots[probe(name_, std::hash<std::string_view>{}(name_))])
+  {
+    return slot - 1;
+  }
+
+  return {};
+}
+
+std::size_t Names::probe(std::string_view const name_, std::size_t const hash_) const
+{
+  auto const mask = _slots.size() - 1;
+
+  // linear probing, the set is never more than half full
+  for (auto i = hash_ & mask;; i = (i + 1) & mask)
+  {
+    auto const slot = _slots[i];
+
+    if (! slot || (_hashes[slot - 1] == hash_ && _names[slot - 1] == name_))
+    {
+      return i;
+    }
+  }
+}
+
+std::string_view Names::store(std::string_view const name_)
+{
+  if (name_.empty())
+  {
+    return {};
+  }
+
+  if (_blocks.empty() || _block_used + name_.size() > _block_size)
+  {
+    // a name larger than the next block gets a block of its own size
+    _block_size = std::max(name_.size(), _blocks.empty() ? block_min :
+      std::min(_block_size * 2, block_max));
+    _blocks.emplace_back(std::make_unique<char[]>(_block_size));
+    _block_used = 0;
+  }
+
+  auto const ptr = _blocks.back().get() + _block_used;
+  std::memcpy(ptr, name_.data(), name_.size());
+  _block_used += name_.size();
+
+  return {ptr, name_.size()};
+}
+
+void Names::rehash(std::size_t const size_)
+{
+  _slots.assign(size_, 0);
+
+  auto const mask = size_ - 1;
+
+  for (std::size_t pos = 0; pos < _names.size(); ++pos)
+  {
+    auto i = _hashes[pos] & mask;
+
+    while (_slots[i])
+    {
+      i = (i + 1) & mask;
+    }
+
+    _slots[i] = static_cast<std::uint32_t>(pos + 1);
+  }
+}
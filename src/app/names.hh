@@ -0,0 +1,127 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef APP_NAMES_HH
+#define APP_NAMES_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// distinct names in insertion order, each stored once in an arena
+// and found through an open addressing hash set of views into it,
+// the views stay valid until the names are destroyed
+class Names final
+{
+public:
+
+  // position of a name in insertion order, stable for the life of the names
+  using Id = std::uint32_t;
+
+  Names() = default;
+  Names(Names&&) = default;
+  Names(Names const&) = delete;
+  ~Names() = default;
+
+  Names& operator=(Names&&) = default;
+  Names& operator=(Names const&) = delete;
+
+  // inserts the name if not present, returns its position
+  // in insertion order and whether it was inserted
+  std::pair<std::size_t, bool> insert(std::string_view const name_);
+
+  // position of the name in insertion order
+  std::optional<std::size_t> find(std::string_view const name_) const;
+
+  std::string_view at(std::size_t const pos_) const
+  {
+    return _names.at(pos_);
+  }
+
+  std::size_t size() const
+  {
+    return _names.size();
+  }
+
+  bool empty() const
+  {
+    return _names.empty();
+  }
+
+private:
+
+  // slot of the name, or the empty slot it would be inserted at
+  std::size_t probe(std::string_view const name_, std::size_t const hash_) const;
+
+  std::string_view store(std::string_view const name_);
+
+  void rehash(std::size_t const size_);
+
+  // arena blocks, a stored name never moves
+  std::vector<std::unique_ptr<char[]>> _blocks;
+
+  // size of the last block
+  std::size_t _block_size {0};
+
+  // bytes used in the last block
+  std::size_t _block_used {0};
+
+  // names in insertion order
+  std::vector<std::string_view> _names;
+
+  // hash of each name in insertion order
+  std::vector<std::size_t> _hashes;
+
+  // position plus one of the name in each slot, zero when empty,
+  // the size is a power of two kept at least twice the number of names
+  std::vector<std::uint32_t> _slots;
+}; // class Names
+
+#endif // APP_NAMES_HH
@@ -0,0 +1,165 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// throughput of the artist url extractor against the ICU regex it replaces,
+// over a page given as the first argument or a generated one
+
+#include "app/extract.hh"
+
+#include "ob/text.hh"
+
+#include <cstddef>
+
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+
+namespace
+{
+
+std::string page_read(char const* path_)
+{
+  std::ifstream file {path_, std::ios::binary};
+
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::string page_generate()
+{
+  // similar in shape to a similar artists page, markup with an artist link
+  // every few hundred bytes
+  std::string page;
+
+  for (std::size_t i = 0; page.size() < 256 * 1024; ++i)
+  {
+    page += "<li class=\"similar-artists-item-wrap\">\n<div class=\"similar-artists-item\">\n";
+    page += "<img src=\"https://lastfm.freetls.fastly.net/i/u/300x300/" + std::to_string(i) + ".jpg\" alt=\"\" loading=\"lazy\">\n";
+    page += "<a href=\"/music/Artist+" + std::to_string(i) + "\" class=\"link-block-target\" title=\"Artist " + std::to_string(i) + "\">\n";
+    page += "<p class=\"similar-artists-item-listeners\">" + std::to_string(i * 1337) + " listeners</p>\n</div>\n</li>\n";
+  }
+
+  return page;
+}
+
+template<typename F>
+void bench(std::string const& name_, std::string const& page_, std::size_t const rounds_, F&& fn_)
+{
+  std::size_t count {0};
+
+  auto const begin = std::chrono::steady_clock::now();
+
+  for (std::size_t i = 0; i < rounds_; ++i)
+  {
+    count += fn_(page_);
+  }
+
+  auto const end = std::chrono::steady_clock::now();
+  auto const sec = std::chrono::duration<double>(end - begin).count();
+  auto const bytes = static_cast<double>(page_.size() * rounds_);
+
+  std::cout
+  << std::left << std::setw(8) << name_
+  << std::right << std::fixed << std::setprecision(3)
+  << std::setw(10) << bytes / sec / 1e9 << " GB/s"
+  << std::setw(10) << count / rounds_ << " matches"
+  << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  auto const page = argc > 1 ? page_read(argv[1]) : page_generate();
+
+  std::size_t const rounds {argc > 2 ? std::stoul(argv[2]) : 200};
+
+  std::cout
+  << "page " << page.size() << " bytes, " << rounds << " rounds\n";
+
+  OB::Text::Regex_Pattern const rx {"href=\"/music/([^/]+?)\"\\s+"};
+  OB::Text::Regex it;
+
+  bench("icu", page, rounds, [&](std::string_view const page_) {
+    std::size_t count {0};
+
+    for (auto const& match : it.find(rx, page_))
+    {
+      count += match.group(0).size() > 0;
+    }
+
+    return count;
+  });
+
+  Extract extract;
+
+  bench("fast", page, rounds, [&](std::string_view const page_) {
+    std::size_t count {0};
+
+    extract.feed(page_, [&](std::string_view const) { ++count; return true; });
+    extract.reset();
+
+    return count;
+  });
+
+  // the same page given in 16 KiB chunks, as read from the socket
+  bench("chunked", page, rounds, [&](std::string_view const page_) {
+    std::size_t count {0};
+
+    for (std::size_t pos = 0; pos < page_.size(); pos += 16384)
+    {
+      extract.feed(page_.substr(pos, 16384), [&](std::string_view const) { ++count; return true; });
+    }
+
+    extract.reset();
+
+    return count;
+  });
+
+  return 0;
+}
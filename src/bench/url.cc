@@ -0,0 +1,266 @@
+/*
+                                    88888888
+                                  888888888888
+                                 88888888888888
+                                8888888888888888
+                               888888888888888888
+                              888888  8888  888888
+                              88888    88    88888
+                              888888  8888  888888
+                              88888888888888888888
+                              88888888888888888888
+                             8888888888888888888888
+                          8888888888888888888888888888
+                        88888888888888888888888888888888
+                              88888888888888888888
+                            888888888888888888888888
+                           888888  8888888888  888888
+                           888     8888  8888     888
+                                   888    888
+
+                                   OCTOBANANA
+
+Licensed under the MIT License
+
+Copyright (c) 2019 Brett Robinson <https://octobanana.com/>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// throughput of the table driven url encode and decode against the
+// string building versions they replace, over artist names given one per
+// line in the file of the first argument or a built in list
+
+#include "ob/belle.hh"
+
+#include <cstddef>
+#include <cctype>
+#include <cstdio>
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+namespace Belle = OB::Belle;
+
+namespace
+{
+
+// a sample of artist names as they appear on similar artist pages
+std::vector<std::string> const names_builtin {
+  "Radiohead", "Thom Yorke", "Atoms for Peace", "Portishead", "Massive Attack",
+  "Björk", "Sigur Rós", "Múm", "Jónsi", "Ólafur Arnalds", "Mogwai",
+  "Godspeed You! Black Emperor", "Explosions in the Sky", "Boards of Canada",
+  "Aphex Twin", "Autechre", "Bonobo", "Four Tet", "Burial", "Jamie xx",
+  "The xx", "Florence + the Machine", "Belle & Sebastian", "Simon & Garfunkel",
+  "Crosby, Stills, Nash & Young", "AC/DC", "Guns N' Roses", "Mötley Crüe",
+  "Motörhead", "Blue Öyster Cult", "Beyoncé", "Sinéad O'Connor", "Mø",
+  "Röyksopp", "Kraftwerk", "Neu!", "Can", "Hüsker Dü", "The Beatles",
+  "Led Zeppelin", "Pink Floyd", "King Crimson", "Yes", "Genesis",
+  "Emerson, Lake & Palmer", "Earth, Wind & Fire", "Sly & the Family Stone",
+  "坂本龍一", "Yellow Magic Orchestra", "宇多田ヒカル", "Perfume", "BABYMETAL",
+  "Кино", "Сплин", "Мумий Тролль", "Ελένη Καραΐνδρου", "Fairuz", "فيروز",
+  "Amadou & Mariam", "Tinariwen", "Bombino", "Ali Farka Touré",
+  "Salif Keita", "Youssou N'Dour", "Caetano Veloso", "João Gilberto",
+  "Tom Jobim", "Os Mutantes", "Gal Costa", "Chico Buarque", "Silvio Rodríguez",
+  "Café Tacvba", "Maná", "Soda Stereo", "Gustavo Cerati", "Los Fabulosos Cadillacs",
+  "!!!", "?uestlove", "Sunn O)))", "Godspeed You Black Emperor!", "50 Foot Wave",
+  "+44", "Florence + The Machine", "100% Silk", "A$AP Rocky", "Ke$ha",
+  "Panic! at the Disco", "Tyler, the Creator", "Mr. Oizo", "Dr. Dre",
+};
+
+std::vector<std::string> names_read(char const* path_)
+{
+  std::vector<std::string> names;
+  std::ifstream file {path_};
+
+  for (std::string line; std::getline(file, line);)
+  {
+    if (line.size())
+    {
+      names.emplace_back(std::move(line));
+    }
+  }
+
+  return names;
+}
+
+// the versions replaced by the table driven ones
+
+std::string hex_encode(char const c)
+{
+  char s[3];
+
+  std::snprintf(&s[0], 3, "%02X", static_cast<unsigned int>(c & 0xff));
+
+  return std::string(s);
+}
+
+char hex_decode(std::string const& s)
+{
+  unsigned int n;
+
+  std::sscanf(s.data(), "%x", &n);
+
+  return static_cast<char>(n);
+}
+
+std::string url_encode_strings(std::string const& str)
+{
+  std::string res;
+  res.reserve(str.size());
+
+  for (auto const& e : str)
+  {
+    if (e == ' ')
+    {
+      res += "+";
+    }
+    else if (std::isalnum(static_cast<unsigned char>(e)) ||
+      e == '-' || e == '_' || e == '.' || e == '~')
+    {
+      res += e;
+    }
+    else
+    {
+      res += "%" + hex_encode(e);
+    }
+  }
+
+  return res;
+}
+
+std::string url_decode_strings(std::string const& str)
+{
+  std::string res;
+  res.reserve(str.size());
+
+  for (std::size_t i = 0; i < str.size(); ++i)
+  {
+    if (str[i] == '+')
+    {
+      res += " ";
+    }
+    else if (str[i] == '%' && i + 2 < str.size() &&
+      std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
+      std::isxdigit(static_cast<unsigned char>(str[i + 2])))
+    {
+      res += hex_decode(str.substr(i + 1, 2));
+      i += 2;
+    }
+    else
+    {
+      res += str[i];
+    }
+  }
+
+  return res;
+}
+
+template<typename F>
+void bench(std::string const& name_, std::vector<std::string> const& names_, std::size_t const rounds_, F&& fn_)
+{
+  std::size_t bytes {0};
+  std::size_t size {0};
+
+  for (auto const& e : names_)
+  {
+    bytes += e.size();
+  }
+
+  auto const begin = std::chrono::steady_clock::now();
+
+  for (std::size_t i = 0; i < rounds_; ++i)
+  {
+    for (auto const& e : names_)
+    {
+      size += fn_(e);
+    }
+  }
+
+  auto const end = std::chrono::steady_clock::now();
+  auto const sec = std::chrono::duration<double>(end - begin).count();
+  auto const count = static_cast<double>(names_.size() * rounds_);
+
+  std::cout
+  << std::left << std::setw(16) << name_
+  << std::right << std::fixed << std::setprecision(3)
+  << std::setw(10) << static_cast<double>(bytes * rounds_) / sec / 1e9 << " GB/s"
+  << std::setw(10) << sec / count * 1e9 << " ns/name"
+  << std::setw(10) << size / rounds_ << " bytes"
+  << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  auto const names = argc > 1 ? names_read(argv[1]) : names_builtin;
+
+  std::size_t const rounds {argc > 2 ? std::stoul(argv[2]) : 20000};
+
+  std::vector<std::string> urls;
+
+  for (auto const& e : names)
+  {
+    urls.emplace_back(Belle::Util::url_encode(e));
+
+    if (url_decode_strings(urls.back()) != e ||
+      url_encode_strings(e) != urls.back() ||
+      Belle::Util::url_decode(urls.back()) != e)
+    {
+      std::cerr << "mismatch: " << e << "\n";
+
+      return 1;
+    }
+  }
+
+  std::cout
+  << names.size() << " names, " << rounds << " rounds\n";
+
+  bench("encode strings", names, rounds, [](std::string const& str_) {
+    return url_encode_strings(str_).size();
+  });
+
+  std::string buf;
+
+  bench("encode table", names, rounds, [&](std::string const& str_) {
+    buf.clear();
+    Belle::Util::url_encode(str_, buf);
+
+    return buf.size();
+  });
+
+  bench("decode strings", urls, rounds, [](std::string const& str_) {
+    return url_decode_strings(str_).size();
+  });
+
+  bench("decode table", urls, rounds, [&](std::string const& str_) {
+    buf.clear();
+    Belle::Util::url_decode(str_, buf);
+
+    return buf.size();
+  });
+
+  return 0;
+}
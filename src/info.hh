@@ -64,7 +64,7 @@ inline void program_init(OB::Parg& pg)
   pg.name("lssa").version("0.4.0 (01.08.2019)");
   pg.description("List similar artists.");
 
-  pg.usage("[--colour=<on|off|auto>] [-c|--count=<1-100>] [-H|--header=<key:value>]... [-i|--ignore-case] <artist>...");
+  pg.usage("[-b|--burst=<1-100>] [--cache=<off|read|readwrite>] [--cache-ttl=<1-8760>] [--colour=<on|off|auto>] [-c|--count=<1-100>] [-d|--depth=<0-5>] [--dns-ttl=<0-3600>] [--extract=<fast|icu>] [--fast-open] [-H|--header=<key:value>]... [-i|--ignore-case] [--input=<file|->] [-j|--jobs=<1-100>] [--keepalive=<0-7200>] [--keepalive-interval=<0-7200>] [--keepalive-probes=<0-100>] [--nodelay] [-p|--pages=<1-10>] [-P|--pipeline=<1-10>] [-r|--rate=<0-100>] [--recv-buffer=<0-16777216>] [--send-buffer=<0-16777216>] [--stats] [-s|--stream] [-t|--threads=<1-64>] [<artist>...]");
   pg.usage("[--colour=<on|off|auto>] -h|--help");
   pg.usage("[--colour=<on|off|auto>] -v|--version");
   pg.usage("[--colour=<on|off|auto>] --license");
@@ -74,8 +74,30 @@ inline void program_init(OB::Parg& pg)
       "list 10 similar artists to <artist>"},
     {"lssa <artist-1> <artist-2>",
       "list 10 similar artists for each <artist-n>"},
+    {"lssa --input=artists.txt",
+      "list 10 similar artists for each artist in 'artists.txt', one artist per line"},
+    {"cat artists.txt | lssa -j 4 --input=-",
+      "list 10 similar artists for each artist read from stdin, fetching 4 artists at a time"},
     {"lssa -c 20 <artist>",
       "list 20 similar artists to <artist>"},
+    {"lssa -d 2 -j 8 -r 0 <artist-1> <artist-2>",
+      "crawl 2 levels of similar artists from each <artist-n>, printing each 'artist -> similar' edge"},
+    {"lssa -j 4 <artist-1> <artist-2> <artist-3> <artist-4>",
+      "list 10 similar artists for each <artist-n>, fetching 4 artists at a time"},
+    {"lssa -c 50 -p 5 <artist>",
+      "list 50 similar artists to <artist>, requesting 5 pages at a time"},
+    {"lssa -c 50 -p 5 -P 5 <artist>",
+      "list 50 similar artists to <artist>, pipelining 5 pages on one connection"},
+    {"lssa -j 4 -r 4 -b 4 <artist-1> <artist-2> <artist-3> <artist-4>",
+      "list 10 similar artists for each <artist-n>, fetching 4 artists at a time at up to 4 requests per second"},
+    {"lssa -j 8 -r 0 -t 4 <artist-1> ... <artist-8>",
+      "list 10 similar artists for each <artist-n>, fetching 8 artists at a time without a rate limit over 4 threads"},
+    {"lssa --cache=readwrite <artist>",
+      "list 10 similar artists to <artist>, reading and storing pages in the cache, a repeat within 24 hours makes no requests"},
+    {"lssa --cache=read --cache-ttl=168 <artist>",
+      "list 10 similar artists to <artist>, using cached pages up to a week old without storing new ones"},
+    {"lssa -s -c 50 <artist> | head -n 6",
+      "print each similar artist to <artist> as soon as it is found, stopping after the first 5"},
     {"lssa -H 'user-agent:custom user agent string' -H 'dnt:1' <artist>",
       "list 10 similar artists to <artist> and pass custom HTTP request headers"},
     {"lssa --help --colour=off",
@@ -117,10 +139,31 @@ inline void program_init(OB::Parg& pg)
   pg.set("license", "Print the program license.");
 
   // options
+  pg.set("burst,b", "1", "1-100", "The number of requests that can be sent at once before the rate limit applies, the default value is '1'.");
+  pg.set("cache", "off", "off|read|readwrite", "Serve pages from the on-disk response cache at '$XDG_CACHE_HOME/lssa', or '~/.cache/lssa' when unset, either off, read to use existing entries, or readwrite to also store fetched pages, the canonical url of each artist name seen is kept alongside to skip redirects, the default value is 'off'.");
+  pg.set("cache-ttl", "24", "1-8760", "The maximum age in hours of a cached page before it is requested again, the default value is '24'.");
   pg.set("colour", "auto", "on|off|auto", "Print the program output with colour either on, off, or auto based on if stdout is a tty, the default value is 'auto'.");
   pg.set("count,c", "10", "1-100", "The maximum number of matches to find for each artist, the default value is '10'.");
+  pg.set("depth,d", "0", "0-5", "The number of levels of similar artists to crawl breadth first from the given artists, printing each 'artist -> similar' edge, each artist is fetched once, a value of '0' disables crawling, the default value is '0'.");
+  pg.set("dns-ttl", "60", "0-3600", "The number of seconds to reuse the addresses of a host lookup for new connections, a value of '0' shares only lookups already in progress, the default value is '60'.");
+  pg.set("extract", "fast", "fast|icu", "Find the similar artists in each page with either the fast extractor or the equivalent ICU regex, the default value is 'fast'.");
+  pg.set("fast-open", "Send the first bytes of each connection with its connection request, when the host has allowed it on an earlier connection and the system supports TCP fast open, only used when the host resolves to a single address, so that several addresses are still raced.");
   pg.set("header,H", {}, "key:value", "Pass a custom HTTP request header, this option can be used multiple times.", true);
   pg.set("ignore-case,i", "Ignore artist case and use titlecase.");
+  pg.set("input", "", "file|-", "Read artists from a file, one per line, or from stdin when the value is '-', artists are read as they are needed and follow any positional artists.");
+  pg.set("jobs,j", "1", "1-100", "The number of artists to fetch concurrently, the default value is '1'.");
+  pg.set("keepalive", "0", "0-7200", "The number of seconds a connection is idle before the first keepalive probe is sent, a value of '0' disables keepalive, the default value is '0'.");
+  pg.set("keepalive-interval", "0", "0-7200", "The number of seconds between keepalive probes, a value of '0' keeps the system default, the default value is '0'.");
+  pg.set("keepalive-probes", "0", "0-100", "The number of unanswered keepalive probes before a connection is dropped, a value of '0' keeps the system default, the default value is '0'.");
+  pg.set("nodelay", "Send each request at once instead of letting the system coalesce small writes, setting TCP_NODELAY on the connections.");
+  pg.set("pages,p", "1", "1-10", "The number of pages to request concurrently for each artist, the default value is '1'.");
+  pg.set("pipeline,P", "1", "1-10", "The number of requests to pipeline on each connection, written back-to-back without waiting on each response, the default value is '1'.");
+  pg.set("rate,r", "1", "0-100", "The maximum number of requests per second to send to the host, a value of '0' removes the limit, the default value is '1'.");
+  pg.set("recv-buffer", "0", "0-16777216", "The socket receive buffer size in bytes of each connection, a value of '0' keeps the system default, the default value is '0'.");
+  pg.set("send-buffer", "0", "0-16777216", "The socket send buffer size in bytes of each connection, a value of '0' keeps the system default, the default value is '0'.");
+  pg.set("stats", "Print the number of responses read, the heap allocations made reading them, one per header field and one per reused body, read or decode buffer that grew, the number of times a reused match vector grew, the TLS handshakes that resumed a session or were full, and the DNS lookups made, to stderr once finished.");
+  pg.set("stream,s", "Print each similar artist as soon as it is found instead of once all pages of the artist are fetched, the output is the same either way.");
+  pg.set("threads,t", "1", "1-64", "The number of threads to run the network I/O and page parsing on, the default value is '1'.");
 
   // allow and capture positional arguments
   pg.set_pos();
@@ -190,11 +233,12 @@ inline int program_info(OB::Parg& pg)
     return 1;
   }
 
-  if (auto const artist_count = pg.get_pos_vec().size(); artist_count == 0 || artist_count > 100)
+  if (auto const artist_count = pg.get_pos_vec().size();
+    (artist_count == 0 && pg.get<std::string>("input").empty()) || artist_count > 100)
   {
     if (artist_count == 0)
     {
-      pg.error("missing required argument <artist>, expected at least one artist");
+      pg.error("missing required argument <artist>, expected at least one artist or --input");
     }
     else
     {
@@ -210,6 +254,46 @@ inline int program_info(OB::Parg& pg)
     return -1;
   }
 
+  if (pg.get<std::size_t>("burst") < 1 || pg.get<std::size_t>("burst") > 100)
+  {
+    pg.error("burst is out of range, value must be between 1-100");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (auto const cache = pg.get<std::string>("cache");
+    cache != "off" && cache != "read" && cache != "readwrite")
+  {
+    pg.error("cache is invalid, value must be one of off, read, or readwrite");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("cache-ttl") < 1 || pg.get<std::size_t>("cache-ttl") > 8760)
+  {
+    pg.error("cache-ttl is out of range, value must be between 1-8760");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
   if (pg.get<std::size_t>("count") < 1 || pg.get<std::size_t>("count") > 100)
   {
     pg.error("count is out of range, value must be between 1-100");
@@ -223,6 +307,176 @@ inline int program_info(OB::Parg& pg)
     return -1;
   }
 
+  if (pg.get<std::size_t>("depth") > 5)
+  {
+    pg.error("depth is out of range, value must be between 0-5");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("dns-ttl") > 3600)
+  {
+    pg.error("dns-ttl is out of range, value must be between 0-3600");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (auto const extract = pg.get<std::string>("extract");
+    extract != "fast" && extract != "icu")
+  {
+    pg.error("extract is invalid, value must be one of fast or icu");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("jobs") < 1 || pg.get<std::size_t>("jobs") > 100)
+  {
+    pg.error("jobs is out of range, value must be between 1-100");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("keepalive") > 7200)
+  {
+    pg.error("keepalive is out of range, value must be between 0-7200");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("keepalive-interval") > 7200)
+  {
+    pg.error("keepalive-interval is out of range, value must be between 0-7200");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("keepalive-probes") > 100)
+  {
+    pg.error("keepalive-probes is out of range, value must be between 0-100");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("pages") < 1 || pg.get<std::size_t>("pages") > 10)
+  {
+    pg.error("pages is out of range, value must be between 1-10");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("pipeline") < 1 || pg.get<std::size_t>("pipeline") > 10)
+  {
+    pg.error("pipeline is out of range, value must be between 1-10");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("rate") > 100)
+  {
+    pg.error("rate is out of range, value must be between 0-100");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("recv-buffer") > 16777216)
+  {
+    pg.error("recv-buffer is out of range, value must be between 0-16777216");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("send-buffer") > 16777216)
+  {
+    pg.error("send-buffer is out of range, value must be between 0-16777216");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
+  if (pg.get<std::size_t>("threads") < 1 || pg.get<std::size_t>("threads") > 64)
+  {
+    pg.error("threads is out of range, value must be between 1-64");
+
+    // an error occurred
+    std::cerr
+    << pg.usage()
+    << "\n"
+    << pg.error();
+
+    return -1;
+  }
+
   // success
   return 0;
 }
@@ -79,10 +79,36 @@ int main(int argc, char** argv)
     App app;
 
     app.artists(pg.get_pos_vec(), pg.get<bool>("ignore-case"));
+    app.burst(pg.get<std::size_t>("burst"));
+    app.cache(pg.get<std::string>("cache"));
+    app.cache_ttl(pg.get<std::size_t>("cache-ttl"));
     app.color(color);
     app.count(pg.get<std::size_t>("count"));
+    app.depth(pg.get<std::size_t>("depth"));
+    app.dns_ttl(pg.get<std::size_t>("dns-ttl"));
+    app.extract(pg.get<std::string>("extract"));
+    app.fast_open(pg.get<bool>("fast-open"));
     app.headers(pg.get_all<std::string>("header"));
+
+    if (auto const input = pg.get<std::string>("input"); input.size())
+    {
+      app.input(input);
+    }
+
+    app.jobs(pg.get<std::size_t>("jobs"));
+    app.keepalive(pg.get<std::size_t>("keepalive"));
+    app.keepalive_interval(pg.get<std::size_t>("keepalive-interval"));
+    app.keepalive_probes(pg.get<std::size_t>("keepalive-probes"));
+    app.nodelay(pg.get<bool>("nodelay"));
+    app.pages(pg.get<std::size_t>("pages"));
+    app.pipeline(pg.get<std::size_t>("pipeline"));
     app.progress(Term::is_term(STDERR_FILENO));
+    app.rate(pg.get<std::size_t>("rate"));
+    app.recv_buffer(pg.get<std::size_t>("recv-buffer"));
+    app.send_buffer(pg.get<std::size_t>("send-buffer"));
+    app.stats(pg.get<bool>("stats"));
+    app.stream(pg.get<bool>("stream"));
+    app.threads(pg.get<std::size_t>("threads"));
 
     app.run();
   }
@@ -120,12 +120,14 @@ SOFTWARE.
 
 #include <cstdio>
 #include <cctype>
+#include <ctime>
 #include <cstdlib>
 #include <cstddef>
 #include <cstdint>
 #include <csignal>
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 #include <vector>
@@ -144,6 +146,8 @@ SOFTWARE.
 #include <optional>
 #include <limits>
 #include <type_traits>
+#include <atomic>
+#include <mutex>
 #include <thread>
 #include <fstream>
 #include <filesystem>
@@ -786,6 +790,8 @@ std::unordered_map<std::string, std::string> const mime_types
 
 // prototypes
 inline std::string mime_type(fs::path const& path);
+inline void url_encode(std::string_view const str, std::string& res);
+inline void url_decode(std::string_view const str, std::string& res);
 inline std::string url_encode(std::string const& str);
 inline std::string url_decode(std::string const& str);
 #ifdef OB_BELLE_CONFIG_ZLIB_ON
@@ -811,54 +817,138 @@ inline std::string mime_type(fs::path const& path)
   return "application/octet-stream";
 }
 
-inline std::string url_encode(std::string const& str)
+// bytes url_encode leaves as is
+inline constexpr auto url_unreserved = []()
 {
-  std::string res;
-  res.reserve(str.size());
+  std::array<bool, 256> res {};
+
+  for (int c = 0; c < 256; ++c)
+  {
+    res[static_cast<std::size_t>(c)] = (c >= '0' && c <= '9') ||
+      (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+      c == '-' || c == '_' || c == '.' || c == '~';
+  }
+
+  return res;
+}();
+
+// value of each hex digit byte, -1 for any other byte
+inline constexpr auto url_hex_value = []()
+{
+  std::array<signed char, 256> res {};
+
+  for (int c = 0; c < 256; ++c)
+  {
+    res[static_cast<std::size_t>(c)] = static_cast<signed char>(
+      c >= '0' && c <= '9' ? c - '0' :
+      c >= 'A' && c <= 'F' ? c - 'A' + 10 :
+      c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1);
+  }
+
+  return res;
+}();
+
+inline constexpr char url_hex_digit[] {"0123456789ABCDEF"};
+
+// appends the url encoding of str to res,
+// runs of unreserved bytes are appended whole
+inline void url_encode(std::string_view const str, std::string& res)
+{
+  res.reserve(res.size() + str.size());
 
-  for (auto const& e : str)
+  for (std::size_t i = 0; i < str.size();)
   {
-    if (e == ' ')
+    auto end = i;
+
+    while (end < str.size() && url_unreserved[static_cast<unsigned char>(str[end])])
+    {
+      ++end;
+    }
+
+    res.append(str.data() + i, end - i);
+
+    if (end == str.size())
     {
-      res += "+";
+      break;
     }
-    else if (std::isalnum(static_cast<unsigned char>(e)) ||
-      e == '-' || e == '_' || e == '.' || e == '~')
+
+    auto const c = static_cast<unsigned char>(str[end]);
+
+    if (c == ' ')
     {
-      res += e;
+      res += '+';
     }
     else
     {
-      res += "%" + Detail::hex_encode(e);
+      char const hex[3] {'%', url_hex_digit[c >> 4], url_hex_digit[c & 0x0f]};
+      res.append(hex, 3);
     }
-  }
 
-  return res;
+    i = end + 1;
+  }
 }
 
-inline std::string url_decode(std::string const& str)
+// appends the url decoding of str to res,
+// runs of bytes without a '+' or '%' are appended whole
+inline void url_decode(std::string_view const str, std::string& res)
 {
-  std::string res;
-  res.reserve(str.size());
+  res.reserve(res.size() + str.size());
 
-  for (std::size_t i = 0; i < str.size(); ++i)
+  for (std::size_t i = 0; i < str.size();)
   {
-    if (str[i] == '+')
+    auto end = i;
+
+    while (end < str.size() && str[end] != '+' && str[end] != '%')
+    {
+      ++end;
+    }
+
+    res.append(str.data() + i, end - i);
+
+    if (end == str.size())
     {
-      res += " ";
+      break;
     }
-    else if (str[i] == '%' && i + 2 < str.size() &&
-      std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
-      std::isxdigit(static_cast<unsigned char>(str[i + 2])))
+
+    if (str[end] == '+')
     {
-      res += Detail::hex_decode(str.substr(i + 1, 2));
-      i += 2;
+      res += ' ';
+      i = end + 1;
+
+      continue;
     }
-    else
+
+    if (end + 2 < str.size())
     {
-      res += str[i];
+      auto const hi = url_hex_value[static_cast<unsigned char>(str[end + 1])];
+      auto const lo = url_hex_value[static_cast<unsigned char>(str[end + 2])];
+
+      if (hi >= 0 && lo >= 0)
+      {
+        res += static_cast<char>((hi << 4) | lo);
+        i = end + 3;
+
+        continue;
+      }
     }
+
+    res += '%';
+    i = end + 1;
   }
+}
+
+inline std::string url_encode(std::string const& str)
+{
+  std::string res;
+  url_encode(str, res);
+
+  return res;
+}
+
+inline std::string url_decode(std::string const& str)
+{
+  std::string res;
+  url_decode(str, res);
 
   return res;
 }
@@ -919,6 +1009,122 @@ inline std::string gzip_decode(std::string const& str)
 
   return body.str();
 }
+
+// inflates a gzip or zlib stream as it arrives,
+// the z_stream is kept for reuse between streams
+class Inflate final
+{
+public:
+
+  Inflate()
+  {
+    if (inflateInit2(&_zs, MAX_WBITS + 32) != Z_OK)
+    {
+      throw std::runtime_error("failed to init inflate");
+    }
+  }
+
+  Inflate(Inflate&&) = delete;
+  Inflate(Inflate const&) = delete;
+
+  ~Inflate()
+  {
+    inflateEnd(&_zs);
+  }
+
+  Inflate& operator=(Inflate&&) = delete;
+  Inflate& operator=(Inflate const&) = delete;
+
+  // ready for the next stream
+  void reset()
+  {
+    inflateReset(&_zs);
+    _done = false;
+  }
+
+  // true once the end of the stream has been inflated
+  bool done() const
+  {
+    return _done;
+  }
+
+  // inflates a whole stream into out_, reusing its capacity
+  void decode(std::string_view const str_, std::string& out_)
+  {
+    reset();
+    out_.clear();
+
+    // a gzip stream ends with the inflated size modulo 2^32,
+    // bounded by the largest ratio deflate can reach
+    if (str_.size() >= 18 &&
+      static_cast<unsigned char>(str_[0]) == 0x1f &&
+      static_cast<unsigned char>(str_[1]) == 0x8b)
+    {
+      std::size_t size {0};
+
+      for (std::size_t i = 0; i < 4; ++i)
+      {
+        size |= static_cast<std::size_t>(
+          static_cast<unsigned char>(str_[str_.size() - 4 + i])) << (8 * i);
+      }
+
+      out_.reserve(std::min(size, str_.size() * 1032));
+    }
+
+    write(str_, [&](std::string_view const buf_)
+    {
+      out_.append(buf_);
+    });
+
+    if (! _done)
+    {
+      throw std::runtime_error("failed to inflate");
+    }
+  }
+
+  // inflates the next input, calling fn_ with each block of output,
+  // the view is only valid for the call
+  template<typename F>
+  void write(std::string_view const str_, F&& fn_)
+  {
+    _zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str_.data()));
+    _zs.avail_in = static_cast<uInt>(str_.size());
+
+    while (! _done)
+    {
+      _zs.next_out = reinterpret_cast<Bytef*>(_out.data());
+      _zs.avail_out = static_cast<uInt>(_out.size());
+
+      auto const ec = inflate(&_zs, Z_NO_FLUSH);
+
+      if (ec == Z_STREAM_END)
+      {
+        _done = true;
+      }
+      else if (ec != Z_OK && ec != Z_BUF_ERROR)
+      {
+        throw std::runtime_error("failed to inflate");
+      }
+
+      if (auto const size = _out.size() - _zs.avail_out; size)
+      {
+        fn_(std::string_view(_out.data(), size));
+      }
+
+      // a full output block may leave more output pending
+      if (ec == Z_BUF_ERROR || (_zs.avail_in == 0 && _zs.avail_out != 0))
+      {
+        break;
+      }
+    }
+  }
+
+private:
+
+  z_stream _zs {};
+  bool _done {false};
+  std::array<char, 16384> _out {};
+}; // class Inflate
 #endif // OB_BELLE_CONFIG_ZLIB_ON
 
 } // namespace Util
@@ -984,7 +1190,10 @@ public:
       auto it = _params.begin();
       for (; it != _params.end(); ++it)
       {
-        path += Util::url_encode(it->first) + "=" + Util::url_encode(it->second) + "&";
+        Util::url_encode(it->first, path);
+        path += "=";
+        Util::url_encode(it->second, path);
+        path += "&";
       }
       path.pop_back();
     }
@@ -1039,158 +1248,580 @@ private:
 namespace Client
 {
 
-class Http final
+#ifdef OB_BELLE_CONFIG_SSL_ON
+// client TLS sessions by host, shared by any number of clients so that
+// a new connection resumes the last session instead of a full handshake,
+// safe to use from any thread
+class Tls_Cache final
 {
 public:
 
-  struct Status
-  {
-    enum
-    {
-      closed = 0,
-      closing,
-      resolving,
-      connecting,
-      handshaking,
-      error,
-      open,
-      reading,
-      writing,
-    };
-  };
-
-  struct Session_Ctx
-  {
-    // http request
-    Request req {};
+  Tls_Cache() = default;
+  Tls_Cache(Tls_Cache&&) = delete;
+  Tls_Cache(Tls_Cache const&) = delete;
+  ~Tls_Cache() = default;
 
-    // http response
-    http::response<http::string_body> res {};
-  }; // struct Session_Ctx
+  Tls_Cache& operator=(Tls_Cache&&) = delete;
+  Tls_Cache& operator=(Tls_Cache const&) = delete;
 
-  struct Error_Ctx
+  // a new reference to the session of the key, null when none can be resumed
+  SSL_SESSION* get(std::string const& key_)
   {
-    // error code
-    error_code const& ec;
-  }; // struct Error_Ctx
+    std::lock_guard<std::mutex> lock {_mutex};
 
-  // callbacks
-  using fn_on_open = std::function<void(Session_Ctx&)>;
-  using fn_on_read = std::function<void(Session_Ctx&)>;
-  using fn_on_write = std::function<void(Session_Ctx&)>;
-  using fn_on_close = std::function<void(Session_Ctx&)>;
-  using fn_on_error = std::function<void(Error_Ctx&)>;
+    auto const it = _sessions.find(key_);
 
-  struct Attr
-  {
-#ifdef OB_BELLE_CONFIG_SSL_ON
-    // use ssl
-    bool ssl {false};
+    if (it == _sessions.end())
+    {
+      return nullptr;
+    }
 
-    // ssl context
-    ssl::context ssl_context {ssl::context::tlsv12_client};
-#endif // OB_BELLE_CONFIG_SSL_ON
+    if (! resumable(it->second.get()))
+    {
+      _sessions.erase(it);
 
-    // socket status
-    int status {Status::closed};
+      return nullptr;
+    }
 
-    // socket timeout
-    std::chrono::seconds timeout {10};
+    SSL_SESSION_up_ref(it->second.get());
 
-    // address to connect to
-    std::string address {"127.0.0.1"};
+    return it->second.get();
+  }
 
-    // port to connect to
-    unsigned short port {8080};
+  // keep the session of the key, taking over the reference
+  void put(std::string const& key_, SSL_SESSION* session_)
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
 
-    // callbacks
-    fn_on_open on_open {};
-    fn_on_read on_read {};
-    fn_on_write on_write {};
-    fn_on_close on_close {};
-    fn_on_error on_error {};
-  }; // struct Attr
+    _sessions.insert_or_assign(key_, Session_Ptr(session_, SSL_SESSION_free));
+    _changed = true;
+  }
 
-  struct Session_Type
+  // true when a session was added since the sessions were loaded
+  bool changed() const
   {
-    virtual ~Session_Type() = default;
-    virtual void read() = 0;
-    virtual void write(Request&&) = 0;
-    virtual void close() = 0;
-    virtual void error(error_code const&) = 0;
-  }; // struct Session_Type
+    std::lock_guard<std::mutex> lock {_mutex};
 
-  template<typename Derived>
-  class Session_Base : public Session_Type
+    return _changed;
+  }
+
+  // the resumable sessions, one 'key<tab>hex encoded DER' per line
+  std::string save() const
   {
-    Derived& derived()
-    {
-      return static_cast<Derived&>(*this);
-    }
+    std::lock_guard<std::mutex> lock {_mutex};
 
-  public:
+    std::string res;
+    std::vector<unsigned char> der;
 
-    Session_Base(net::io_context& io_, std::shared_ptr<Attr> const attr_) :
-      _resolver {io_},
-      _strand {io_.get_executor()},
-      _timer {io_, (std::chrono::steady_clock::time_point::max)()},
-      _attr {attr_}
+    for (auto const& [key, session] : _sessions)
     {
-    }
+      auto const size = i2d_SSL_SESSION(session.get(), nullptr);
 
-    ~Session_Base()
-    {
-      _attr->status = Status::closed;
-    }
+      if (size <= 0 || ! resumable(session.get()))
+      {
+        continue;
+      }
 
-    void cancel_timer()
-    {
-      // set the timer to expire immediately
-      _timer.expires_at((std::chrono::steady_clock::time_point::min)());
-    }
+      der.resize(static_cast<std::size_t>(size));
+      auto ptr = der.data();
+      i2d_SSL_SESSION(session.get(), &ptr);
 
-    void do_timer()
-    {
-      _timer.cancel();
-      _timer.expires_after(_attr->timeout);
+      res += key;
+      res += '\t';
 
-      // wait on the timer
-      _timer.async_wait(
-        net::bind_executor(_strand,
-          [self = derived().shared_from_this()](error_code ec)
-          {
-            self->on_timer(ec);
-          }
-        )
-      );
+      for (auto const c : der)
+      {
+        res += Util::url_hex_digit[c >> 4];
+        res += Util::url_hex_digit[c & 0x0f];
+      }
+
+      res += '\n';
     }
 
-    void on_timer(error_code ec_)
+    return res;
+  }
+
+  // add the sessions given in the format of save
+  void load(std::string_view const str_)
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    std::vector<unsigned char> der;
+
+    for (std::size_t pos = 0; pos < str_.size();)
     {
-      if (ec_ && ec_ != net::error::operation_aborted)
-      {
-        on_error(ec_);
+      auto end = str_.find('\n', pos);
 
-        return;
+      if (end == std::string_view::npos)
+      {
+        end = str_.size();
       }
 
-      // check if socket has been closed
-      if (_timer.expires_at() == (std::chrono::steady_clock::time_point::min)())
+      auto const line = str_.substr(pos, end - pos);
+      pos = end + 1;
+
+      auto const tab = line.find('\t');
+
+      if (tab == std::string_view::npos || (line.size() - tab - 1) % 2)
       {
-        return;
+        continue;
       }
 
-      // check expiry
-      if (_timer.expiry() <= std::chrono::steady_clock::now())
+      der.clear();
+
+      for (auto i = tab + 1; i + 1 < line.size(); i += 2)
       {
-        derived().do_close();
+        auto const hi = Util::url_hex_value[static_cast<unsigned char>(line[i])];
+        auto const lo = Util::url_hex_value[static_cast<unsigned char>(line[i + 1])];
 
-        return;
+        if (hi < 0 || lo < 0)
+        {
+          break;
+        }
+
+        der.emplace_back(static_cast<unsigned char>((hi << 4) | lo));
       }
 
-      if (_close)
+      if (der.size() * 2 != line.size() - tab - 1)
       {
-        return;
+        continue;
+      }
+
+      unsigned char const* ptr = der.data();
+
+      if (auto const session = d2i_SSL_SESSION(nullptr, &ptr, static_cast<long>(der.size())))
+      {
+        if (resumable(session))
+        {
+          _sessions.insert_or_assign(std::string(line.substr(0, tab)), Session_Ptr(session, SSL_SESSION_free));
+        }
+        else
+        {
+          SSL_SESSION_free(session);
+        }
+      }
+    }
+  }
+
+private:
+
+  using Session_Ptr = std::unique_ptr<SSL_SESSION, decltype(&SSL_SESSION_free)>;
+
+  static bool resumable(SSL_SESSION const* session_)
+  {
+    return SSL_SESSION_is_resumable(session_) &&
+      SSL_SESSION_get_time(session_) + SSL_SESSION_get_timeout(session_) > std::time(nullptr);
+  }
+
+  mutable std::mutex _mutex;
+  std::unordered_map<std::string, Session_Ptr> _sessions;
+  bool _changed {false};
+}; // class Tls_Cache
+#endif // OB_BELLE_CONFIG_SSL_ON
+
+// client name server lookups by host, shared by any number of clients so that
+// opening many connections to a host costs one lookup,
+// safe to use from any thread
+class Dns_Cache final
+{
+public:
+
+  using Endpoints = std::vector<tcp::endpoint>;
+  using fn_on_resolve = std::function<void(error_code const&, Endpoints const&)>;
+
+  Dns_Cache() = default;
+  Dns_Cache(Dns_Cache&&) = delete;
+  Dns_Cache(Dns_Cache const&) = delete;
+  ~Dns_Cache() = default;
+
+  Dns_Cache& operator=(Dns_Cache&&) = delete;
+  Dns_Cache& operator=(Dns_Cache const&) = delete;
+
+  // set how long the endpoints of a lookup are kept,
+  // a value of '0' keeps them only for the clients waiting on the lookup
+  void ttl(std::chrono::seconds const ttl_)
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    _ttl = ttl_;
+  }
+
+  // get how long the endpoints of a lookup are kept
+  std::chrono::seconds ttl() const
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _ttl;
+  }
+
+  // get the number of lookups made
+  std::size_t lookups() const
+  {
+    std::lock_guard<std::mutex> lock {_mutex};
+
+    return _lookups;
+  }
+
+  // call on_resolve with the endpoints of the host, the kept ones when fresh,
+  // else those of the running lookup of the host, or of a new one on the resolver,
+  // on_resolve is called on the thread that completes the lookup
+  void resolve(tcp::resolver& resolver_, std::string const& host_, std::string const& port_,
+    fn_on_resolve on_resolve_)
+  {
+    auto key = host_ + ":" + port_;
+
+    {
+      std::unique_lock<std::mutex> lock {_mutex};
+
+      auto& entry = _entries[key];
+
+      if (entry.endpoints.size() && entry.expiry > std::chrono::steady_clock::now())
+      {
+        auto const endpoints = entry.endpoints;
+        lock.unlock();
+
+        on_resolve_({}, endpoints);
+
+        return;
+      }
+
+      entry.waiting.emplace_back(std::move(on_resolve_));
+
+      // a lookup of the host is running
+      if (entry.waiting.size() > 1)
+      {
+        return;
+      }
+
+      ++_lookups;
+    }
+
+    resolver_.async_resolve(host_, port_,
+      [this, key = std::move(key)]
+      (error_code ec, tcp::resolver::results_type results)
+      {
+        on_lookup(key, ec, endpoints(results));
+      }
+    );
+  }
+
+  // the endpoints of a lookup, ordered to alternate between address families,
+  // starting with the family of the first one
+  static Endpoints endpoints(tcp::resolver::results_type const& results_)
+  {
+    Endpoints res;
+    Endpoints other;
+
+    for (auto const& e : results_)
+    {
+      if (res.empty() || e.endpoint().protocol() == res.front().protocol())
+      {
+        res.emplace_back(e.endpoint());
+      }
+      else
+      {
+        other.emplace_back(e.endpoint());
+      }
+    }
+
+    if (other.empty())
+    {
+      return res;
+    }
+
+    Endpoints first;
+    std::swap(first, res);
+    res.reserve(first.size() + other.size());
+
+    for (std::size_t i = 0; i < first.size() || i < other.size(); ++i)
+    {
+      if (i < first.size())
+      {
+        res.emplace_back(first[i]);
+      }
+
+      if (i < other.size())
+      {
+        res.emplace_back(other[i]);
+      }
+    }
+
+    return res;
+  }
+
+private:
+
+  struct Entry
+  {
+    // endpoints of the last lookup
+    Endpoints endpoints {};
+
+    // time the endpoints stop being used
+    std::chrono::steady_clock::time_point expiry {};
+
+    // callbacks waiting on the running lookup
+    std::vector<fn_on_resolve> waiting {};
+  }; // struct Entry
+
+  void on_lookup(std::string const& key_, error_code const& ec_, Endpoints const& endpoints_)
+  {
+    std::vector<fn_on_resolve> waiting;
+
+    {
+      std::lock_guard<std::mutex> lock {_mutex};
+
+      auto& entry = _entries[key_];
+      std::swap(waiting, entry.waiting);
+
+      // failed lookups are not kept
+      if (! ec_)
+      {
+        entry.endpoints = endpoints_;
+        entry.expiry = std::chrono::steady_clock::now() + _ttl;
+      }
+    }
+
+    for (auto const& fn : waiting)
+    {
+      fn(ec_, endpoints_);
+    }
+  }
+
+  mutable std::mutex _mutex;
+  std::unordered_map<std::string, Entry> _entries;
+  std::chrono::seconds _ttl {60};
+  std::size_t _lookups {0};
+}; // class Dns_Cache
+
+class Http final
+{
+public:
+
+  struct Status
+  {
+    enum
+    {
+      closed = 0,
+      closing,
+      resolving,
+      connecting,
+      handshaking,
+      error,
+      open,
+      reading,
+      writing,
+    };
+  };
+
+  struct Session_Ctx
+  {
+    // http request
+    Request req {};
+
+    // http response
+    http::response<http::string_body> res {};
+  }; // struct Session_Ctx
+
+  struct Error_Ctx
+  {
+    // error code
+    error_code const& ec;
+  }; // struct Error_Ctx
+
+  // callbacks
+  using fn_on_open = std::function<void(Session_Ctx&)>;
+  using fn_on_read = std::function<void(Session_Ctx&)>;
+  using fn_on_write = std::function<void(Session_Ctx&)>;
+  using fn_on_close = std::function<void(Session_Ctx&)>;
+  using fn_on_error = std::function<void(Error_Ctx&)>;
+
+  // called with each part of a response body as it is read,
+  // after the response header has been set
+  using fn_on_data = std::function<void(Session_Ctx&, std::string_view)>;
+
+  struct Pipeline_Ctx
+  {
+    // http request
+    Request req {};
+
+    // callback for the matching response
+    fn_on_read on_read {};
+
+    // when set, the matching response body is passed to it as it is read,
+    // and not kept in the response
+    fn_on_data on_data {};
+  }; // struct Pipeline_Ctx
+
+  struct Attr
+  {
+#ifdef OB_BELLE_CONFIG_SSL_ON
+    // use ssl
+    bool ssl {false};
+
+    // ssl context
+    ssl::context ssl_context {ssl::context::tlsv12_client};
+
+    // sessions to resume, shared with other clients
+    std::shared_ptr<Tls_Cache> tls_cache {};
+
+    // number of handshakes that resumed a session, read from any thread
+    std::atomic<std::size_t> handshakes_resumed {0};
+
+    // number of full handshakes, read from any thread
+    std::atomic<std::size_t> handshakes_full {0};
+#endif // OB_BELLE_CONFIG_SSL_ON
+
+    // socket status, read from any thread
+    std::atomic<int> status {Status::closed};
+
+    // socket timeout
+    std::chrono::seconds timeout {10};
+
+    // lookups to share, when unset each connection makes its own
+    std::shared_ptr<Dns_Cache> dns_cache {};
+
+    // time to wait on a connection attempt before racing it
+    // with an attempt to the next endpoint
+    std::chrono::milliseconds connect_delay {250};
+
+    // send small writes at once instead of coalescing them, TCP_NODELAY
+    bool no_delay {false};
+
+    // socket send buffer size in bytes, 0 keeps the system default
+    std::size_t send_buffer_size {0};
+
+    // socket receive buffer size in bytes, 0 keeps the system default
+    std::size_t recv_buffer_size {0};
+
+    // send the first write with the connection request when the host
+    // has given a cookie before, TCP_FASTOPEN_CONNECT where available,
+    // only used when the host has a single endpoint, as such a connect
+    // completes at once and would always win the race of the endpoints
+    bool fast_open {false};
+
+    // probe idle connections to keep them open and find dead ones
+    bool keep_alive {false};
+
+    // idle time before the first probe, 0 keeps the system default
+    std::chrono::seconds keep_alive_idle {0};
+
+    // time between probes, 0 keeps the system default
+    std::chrono::seconds keep_alive_interval {0};
+
+    // number of unanswered probes before the connection is dropped,
+    // 0 keeps the system default
+    std::size_t keep_alive_count {0};
+
+    // decode compressed response bodies
+    bool decode {true};
+
+    // keep the response body and read buffer storage between responses
+    bool recycle {false};
+
+    // number of responses read, read from any thread
+    std::atomic<std::size_t> responses {0};
+
+    // number of heap allocations made reading responses, read from any
+    // thread, one for each header field parsed and one for each of the
+    // body, read and decode buffers whose capacity grew during a response
+    std::atomic<std::size_t> allocations {0};
+
+    // address to connect to
+    std::string address {"127.0.0.1"};
+
+    // port to connect to
+    unsigned short port {8080};
+
+    // callbacks
+    fn_on_open on_open {};
+    fn_on_read on_read {};
+    fn_on_write on_write {};
+    fn_on_close on_close {};
+    fn_on_error on_error {};
+  }; // struct Attr
+
+  struct Session_Type
+  {
+    virtual ~Session_Type() = default;
+    virtual void read() = 0;
+    virtual void write(Request&&) = 0;
+    virtual void pipeline(Request&&, fn_on_read&&, fn_on_data&&) = 0;
+    virtual void close() = 0;
+    virtual void error(error_code const&) = 0;
+  }; // struct Session_Type
+
+  template<typename Derived>
+  class Session_Base : public Session_Type
+  {
+    Derived& derived()
+    {
+      return static_cast<Derived&>(*this);
+    }
+
+  public:
+
+    Session_Base(net::io_context& io_, std::shared_ptr<Attr> const attr_) :
+      _resolver {io_},
+      _strand {io_.get_executor()},
+      _timer {io_, (std::chrono::steady_clock::time_point::max)()},
+      _stagger {io_},
+      _attr {attr_}
+    {
+    }
+
+    ~Session_Base()
+    {
+      _attr->status = Status::closed;
+    }
+
+    void cancel_timer()
+    {
+      // set the timer to expire immediately
+      _timer.expires_at((std::chrono::steady_clock::time_point::min)());
+    }
+
+    void do_timer()
+    {
+      _timer.cancel();
+      _timer.expires_after(_attr->timeout);
+
+      // wait on the timer
+      _timer.async_wait(
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec)
+          {
+            self->on_timer(ec);
+          }
+        )
+      );
+    }
+
+    void on_timer(error_code ec_)
+    {
+      if (ec_ && ec_ != net::error::operation_aborted)
+      {
+        on_error(ec_);
+
+        return;
+      }
+
+      // check if socket has been closed
+      if (_timer.expires_at() == (std::chrono::steady_clock::time_point::min)())
+      {
+        return;
+      }
+
+      // check expiry
+      if (_timer.expiry() <= std::chrono::steady_clock::now())
+      {
+        derived().do_close();
+
+        return;
+      }
+
+      if (_close)
+      {
+        return;
       }
     }
 
@@ -1199,73 +1830,310 @@ public:
       _attr->status = Status::resolving;
 
       // domain name server lookup
+      if (_attr->dns_cache)
+      {
+        _attr->dns_cache->resolve(_resolver, _attr->address, Detail::to_string(_attr->port),
+          [self = derived().shared_from_this()]
+          (error_code const& ec, Dns_Cache::Endpoints const& endpoints)
+          {
+            net::dispatch(self->_strand, [self, ec, endpoints = Dns_Cache::Endpoints(endpoints)]() mutable
+            {
+              self->on_resolve(ec, std::move(endpoints));
+            });
+          }
+        );
+
+        return;
+      }
+
       _resolver.async_resolve(_attr->address,
         Detail::to_string(_attr->port),
         net::bind_executor(_strand,
           [self = derived().shared_from_this()]
           (error_code ec, tcp::resolver::results_type results)
           {
-            self->on_resolve(ec, results);
+            self->on_resolve(ec, Dns_Cache::endpoints(results));
+          }
+        )
+      );
+    }
+
+    void on_resolve(error_code ec_, Dns_Cache::Endpoints&& endpoints_)
+    {
+      if (! ec_ && endpoints_.empty())
+      {
+        ec_ = net::error::host_not_found;
+      }
+
+      if (ec_)
+      {
+        on_error(ec_);
+
+        return;
+      }
+
+      _attr->status = Status::connecting;
+
+      _endpoints = std::move(endpoints_);
+      do_connect();
+    }
+
+    // start an attempt to connect to the next endpoint,
+    // racing the running attempts as in RFC 8305
+    void do_connect()
+    {
+      auto const index = _attempts.size();
+      auto& socket = _attempts.emplace_back(_resolver.get_executor());
+      ++_connecting;
+
+      // the options are set before the connect, so that the buffer sizes
+      // apply to the window in the handshake, and fast open can be used
+      error_code ec_open;
+      socket.open(_endpoints[index].protocol(), ec_open);
+
+      if (! ec_open)
+      {
+        socket_options(socket);
+      }
+
+      socket.async_connect(_endpoints[index],
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this(), index](error_code ec)
+          {
+            self->on_connect_attempt(ec, index);
           }
         )
       );
+
+      // start the next attempt if this one has not finished by the delay
+      if (_attempts.size() < _endpoints.size())
+      {
+        _stagger.expires_after(_attr->connect_delay);
+        _stagger.async_wait(
+          net::bind_executor(_strand,
+            [self = derived().shared_from_this()](error_code ec)
+            {
+              if (! ec && ! self->_closing && self->_attempts.size() < self->_endpoints.size())
+              {
+                self->do_connect();
+              }
+            }
+          )
+        );
+      }
     }
 
-    void on_resolve(error_code ec_, tcp::resolver::results_type results_)
-    {
-      if (ec_)
+    void on_connect_attempt(error_code ec_, std::size_t const index_)
+    {
+      --_connecting;
+
+      // another attempt has connected
+      if (_attempts.empty())
+      {
+        return;
+      }
+
+      if (_closing && ! ec_)
+      {
+        ec_ = net::error::operation_aborted;
+      }
+
+      if (ec_)
+      {
+        // start the next attempt without waiting on the delay
+        if (! _closing && _attempts.size() < _endpoints.size())
+        {
+          do_connect();
+
+          return;
+        }
+
+        // the last attempt has failed
+        if (_connecting == 0)
+        {
+          connect_cancel();
+          derived().on_connect(ec_);
+        }
+
+        return;
+      }
+
+      // the first attempt to connect is kept, the others are closed
+      derived().socket().lowest_layer() = std::move(_attempts[index_]);
+      connect_cancel();
+
+      derived().on_connect(ec_);
+    }
+
+    // set the socket options of the attr, the ones the system
+    // does not support are skipped
+    void socket_options(tcp::socket& socket_)
+    {
+      error_code ec;
+
+      if (_attr->no_delay)
+      {
+        socket_.set_option(tcp::no_delay(true), ec);
+      }
+
+      if (_attr->send_buffer_size)
+      {
+        socket_.set_option(net::socket_base::send_buffer_size(static_cast<int>(_attr->send_buffer_size)), ec);
+      }
+
+      if (_attr->recv_buffer_size)
+      {
+        socket_.set_option(net::socket_base::receive_buffer_size(static_cast<int>(_attr->recv_buffer_size)), ec);
+      }
+
+#ifdef TCP_FASTOPEN_CONNECT
+      // with a cookie the connect completes without waiting on the host,
+      // so a dead endpoint would win the race and fail on the first write
+      if (_attr->fast_open && _endpoints.size() == 1)
+      {
+        socket_.set_option(net::detail::socket_option::integer<IPPROTO_TCP, TCP_FASTOPEN_CONNECT>(1), ec);
+      }
+#endif // TCP_FASTOPEN_CONNECT
+
+      if (_attr->keep_alive)
       {
-        on_error(ec_);
+        socket_.set_option(net::socket_base::keep_alive(true), ec);
 
-        return;
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+        if (_attr->keep_alive_idle.count())
+        {
+          socket_.set_option(net::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPIDLE>(
+            static_cast<int>(_attr->keep_alive_idle.count())), ec);
+        }
+
+        if (_attr->keep_alive_interval.count())
+        {
+          socket_.set_option(net::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPINTVL>(
+            static_cast<int>(_attr->keep_alive_interval.count())), ec);
+        }
+
+        if (_attr->keep_alive_count)
+        {
+          socket_.set_option(net::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPCNT>(
+            static_cast<int>(_attr->keep_alive_count)), ec);
+        }
+#endif // TCP_KEEPIDLE && TCP_KEEPINTVL && TCP_KEEPCNT
       }
+    }
 
-      _attr->status = Status::connecting;
+    // close the running connection attempts
+    void connect_cancel()
+    {
+      _stagger.cancel();
 
-      // connect to the endpoint
-      net::async_connect(derived().socket().lowest_layer(),
-        results_.begin(), results_.end(),
-        net::bind_executor(_strand,
-          [self = derived().shared_from_this()](error_code ec, auto)
-          {
-            self->derived().on_connect(ec);
-          }
-        )
-      );
+      error_code ec;
+
+      for (auto& socket : _attempts)
+      {
+        socket.close(ec);
+      }
+
+      _attempts.clear();
+      _endpoints.clear();
     }
 
-    void prepare_req()
+    void prepare_req(Request& req_)
     {
       // serialize target and params
-      _ctx.req.params_serialize();
+      req_.params_serialize();
 
       // set default user-agent header value if not present
-      if (_ctx.req.find(Header::user_agent) == _ctx.req.end())
+      if (req_.find(Header::user_agent) == req_.end())
       {
-        _ctx.req.set(Header::user_agent, "Belle");
+        req_.set(Header::user_agent, "Belle");
       }
 
       // set default host header value if not present
-      if (_ctx.req.find(Header::host) == _ctx.req.end())
+      if (req_.find(Header::host) == req_.end())
       {
-        _ctx.req.set(Header::host, _attr->address);
+        req_.set(Header::host, _attr->address);
       }
 
 #ifdef OB_BELLE_CONFIG_ZLIB_ON
       // set default accept-encoding header value if not present
-      if (_ctx.req.find(Header::accept_encoding) == _ctx.req.end())
+      if (req_.find(Header::accept_encoding) == req_.end())
       {
-        _ctx.req.set(Header::accept_encoding, "gzip, deflate");
+        req_.set(Header::accept_encoding, "gzip, deflate");
       }
 #endif // OB_BELLE_CONFIG_ZLIB_ON
 
       // prepare the payload
-      _ctx.req.prepare_payload();
+      req_.prepare_payload();
+    }
+
+    void decode_res()
+    {
+#ifdef OB_BELLE_CONFIG_ZLIB_ON
+      if (_attr->decode && _ctx.res.body().size() && _ctx.res["content-encoding"] != "" &&
+        _ctx.res["content-encoding"] != "identity")
+      {
+        if (auto const encoding = _ctx.res["content-encoding"];
+          encoding == "gzip" || encoding == "deflate")
+        {
+          // the encoded body becomes the output buffer of the next response
+          _inflate.decode(_ctx.res.body(), _decoded);
+          std::swap(_ctx.res.body(), _decoded);
+        }
+      }
+#endif // OB_BELLE_CONFIG_ZLIB_ON
+    }
+
+    void res_clear()
+    {
+      if (_attr->recycle)
+      {
+        // the body keeps its capacity, the fields are rebuilt by the parser
+        auto body = std::move(_ctx.res.body());
+        body.clear();
+        _ctx.res = {};
+        _ctx.res.body() = std::move(body);
+      }
+      else
+      {
+        _ctx.res = {};
+      }
+
+      _capacity = res_capacity();
+    }
+
+    std::array<std::size_t, 3> res_capacity() const
+    {
+      std::array<std::size_t, 3> size {_ctx.res.body().capacity(), _buf.capacity(), 0};
+#ifdef OB_BELLE_CONFIG_ZLIB_ON
+      size.at(2) = _decoded.capacity();
+#endif // OB_BELLE_CONFIG_ZLIB_ON
+
+      return size;
+    }
+
+    // counts the response and the allocations made reading it,
+    // each header field is allocated on its own
+    void res_count()
+    {
+      ++_attr->responses;
+
+      auto allocations = static_cast<std::size_t>(std::distance(_ctx.res.begin(), _ctx.res.end()));
+      auto const size = res_capacity();
+
+      for (std::size_t i = 0; i < size.size(); ++i)
+      {
+        if (size.at(i) > _capacity.at(i))
+        {
+          ++allocations;
+        }
+      }
+
+      _attr->allocations += allocations;
     }
 
     void do_write()
     {
-      prepare_req();
+      prepare_req(_ctx.req);
       do_timer();
 
       _attr->status = Status::writing;
@@ -1311,7 +2179,7 @@ public:
     void do_read()
     {
       // clear the HTTP response
-      _ctx.res = {};
+      res_clear();
       do_timer();
 
       _attr->status = Status::reading;
@@ -1344,33 +2212,275 @@ public:
       {
         try
         {
-#ifdef OB_BELLE_CONFIG_ZLIB_ON
-          if (_ctx.res.body().size() && _ctx.res["content-encoding"] != "" &&
-            _ctx.res["content-encoding"] != "identity")
+          decode_res();
+          res_count();
+
+          // run user function
+          _attr->on_read(_ctx);
+        }
+        catch (...)
+        {
+          on_error();
+        }
+      }
+    }
+
+    // pipelined requests are written back-to-back as they are queued,
+    // while their responses are read in order and matched FIFO
+    void do_pipeline_write()
+    {
+      _pipeline_writing = true;
+
+      // move the request into the queue of requests awaiting a response
+      auto& req = _pipeline_wait.emplace_back(std::move(_pipeline_queue.front())).req;
+      _pipeline_queue.pop_front();
+
+      prepare_req(req);
+      do_timer();
+
+      if (! _pipeline_reading)
+      {
+        _attr->status = Status::writing;
+      }
+
+      // Send the HTTP request
+      http::async_write(derived().socket(), req,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
           {
-            if (_ctx.res["content-encoding"] == "gzip")
-            {
-              _ctx.res.body() = OB::Belle::Util::gzip_decode(_ctx.res.body());
-            }
-            else if (_ctx.res["content-encoding"] == "deflate")
-            {
-              _ctx.res.body() = OB::Belle::Util::zlib_decode(_ctx.res.body());
-            }
+            self->on_pipeline_write(ec, bytes);
           }
-#endif // OB_BELLE_CONFIG_ZLIB_ON
+        )
+      );
+    }
+
+    void on_pipeline_write(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      _pipeline_writing = false;
+
+      if (_closing)
+      {
+        return;
+      }
+
+      if (ec_)
+      {
+        on_error(ec_);
+
+        return;
+      }
+
+      if (! _pipeline_reading)
+      {
+        do_pipeline_read();
+      }
+
+      if (! _pipeline_queue.empty())
+      {
+        do_pipeline_write();
+      }
+    }
+
+    void do_pipeline_read()
+    {
+      _pipeline_reading = true;
+
+      // clear the HTTP response
+      res_clear();
+      do_timer();
+
+      _attr->status = Status::reading;
+
+      if (_pipeline_wait.front().on_data)
+      {
+        do_pipeline_read_header();
+
+        return;
+      }
+
+      // Receive the HTTP response
+      http::async_read(derived().socket(), _buf, _ctx.res,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_pipeline_read(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void on_pipeline_read(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      _pipeline_reading = false;
+
+      if (_closing)
+      {
+        return;
+      }
+
+      _attr->status = _pipeline_writing ? Status::writing : Status::open;
+
+      if (ec_)
+      {
+        on_error(ec_);
+
+        return;
+      }
+
+      // the response belongs to the oldest request written
+      auto ctx = std::move(_pipeline_wait.front());
+      _pipeline_wait.pop_front();
+      _ctx.req = std::move(ctx.req);
+
+      auto const& on_read = ctx.on_read ? ctx.on_read : _attr->on_read;
+
+      if (on_read)
+      {
+        try
+        {
+          decode_res();
+          res_count();
 
           // run user function
-          _attr->on_read(_ctx);
+          on_read(_ctx);
+        }
+        catch (...)
+        {
+          on_error();
+        }
+      }
+
+      if (! _pipeline_wait.empty() && ! _pipeline_reading && ! _closing)
+      {
+        do_pipeline_read();
+      }
+    }
+
+    // a streamed response is read with a parser into a fixed buffer,
+    // each part of the body is passed on as soon as it arrives
+    void do_pipeline_read_header()
+    {
+      // a parser reads a single message, it is constructed in place
+      _parser.emplace();
+
+      // Receive the HTTP response header
+      http::async_read_header(derived().socket(), _buf, *_parser,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_pipeline_read_header(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void on_pipeline_read_header(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      if (_closing)
+      {
+        _pipeline_reading = false;
+
+        return;
+      }
+
+      if (ec_)
+      {
+        _pipeline_reading = false;
+        on_error(ec_);
+
+        return;
+      }
+
+      // the header fields are moved rather than copied, the parser
+      // only needs its body from here on
+      _ctx.res.base() = std::move(_parser->get().base());
+
+      do_pipeline_read_body();
+    }
+
+    void do_pipeline_read_body()
+    {
+      if (_parser->is_done())
+      {
+        on_pipeline_read({}, 0);
+
+        return;
+      }
+
+      _parser->get().body().data = _chunk.data();
+      _parser->get().body().size = _chunk.size();
+
+      do_timer();
+
+      // Receive the next part of the HTTP response body
+      http::async_read_some(derived().socket(), _buf, *_parser,
+        net::bind_executor(_strand,
+          [self = derived().shared_from_this()](error_code ec, std::size_t bytes)
+          {
+            self->on_pipeline_read_body(ec, bytes);
+          }
+        )
+      );
+    }
+
+    void on_pipeline_read_body(error_code ec_, std::size_t bytes_)
+    {
+      boost::ignore_unused(bytes_);
+
+      // the body buffer is full
+      if (ec_ == http::error::need_buffer)
+      {
+        ec_ = {};
+      }
+
+      if (_closing)
+      {
+        _pipeline_reading = false;
+
+        return;
+      }
+
+      if (ec_)
+      {
+        _pipeline_reading = false;
+        on_error(ec_);
+
+        return;
+      }
+
+      if (auto const size = _chunk.size() - _parser->get().body().size; size)
+      {
+        try
+        {
+          // run user function
+          _pipeline_wait.front().on_data(_ctx, std::string_view(_chunk.data(), size));
         }
         catch (...)
         {
+          _pipeline_reading = false;
           on_error();
+
+          return;
         }
       }
+
+      do_pipeline_read_body();
     }
 
     void on_error(error_code const& ec_ = {})
     {
+      // ignore errors from operations cancelled by the close
+      if (_closing && ec_)
+      {
+        return;
+      }
+
       _attr->status = Status::error;
 
       if (_attr->on_error)
@@ -1387,34 +2497,84 @@ public:
       }
     }
 
+    // the public functions run on the strand,
+    // making them safe to call from any thread
+
     void read()
     {
-      do_read();
+      net::dispatch(_strand, [self = derived().shared_from_this()]()
+      {
+        self->do_read();
+      });
     }
 
     void write(Request&& req_)
     {
-      _ctx.req = std::move(req_);
-      do_write();
+      net::dispatch(_strand, [self = derived().shared_from_this(), req = std::move(req_)]() mutable
+      {
+        self->_ctx.req = std::move(req);
+        self->do_write();
+      });
+    }
+
+    void pipeline(Request&& req_, fn_on_read&& on_read_, fn_on_data&& on_data_)
+    {
+      net::dispatch(_strand, [self = derived().shared_from_this(),
+        ctx = Pipeline_Ctx{std::move(req_), std::move(on_read_), std::move(on_data_)}]() mutable
+      {
+        if (self->_closing)
+        {
+          return;
+        }
+
+        self->_pipeline_queue.emplace_back(std::move(ctx));
+
+        if (! self->_pipeline_writing)
+        {
+          self->do_pipeline_write();
+        }
+      });
     }
 
     void close()
     {
-      derived().do_close();
+      net::dispatch(_strand, [self = derived().shared_from_this()]()
+      {
+        self->derived().do_close();
+      });
     }
 
     void error(error_code const& ec_)
     {
-      on_error(ec_);
+      net::dispatch(_strand, [self = derived().shared_from_this(), ec_]()
+      {
+        self->on_error(ec_);
+      });
     }
 
     tcp::resolver _resolver;
     net::strand<net::io_context::executor_type> _strand;
     net::steady_timer _timer;
+    net::steady_timer _stagger;
     std::shared_ptr<Attr> const _attr;
     Session_Ctx _ctx {};
     beast::flat_buffer _buf {};
+    std::optional<http::response_parser<http::buffer_body>> _parser {};
+    std::array<char, 16384> _chunk {};
+    std::array<std::size_t, 3> _capacity {};
+#ifdef OB_BELLE_CONFIG_ZLIB_ON
+    Util::Inflate _inflate {};
+    std::string _decoded {};
+#endif // OB_BELLE_CONFIG_ZLIB_ON
     bool _close {false};
+    bool _closing {false};
+    Dns_Cache::Endpoints _endpoints {};
+    std::deque<tcp::socket> _attempts {};
+    std::size_t _connecting {0};
+    std::deque<Pipeline_Ctx> _pipeline_queue {};
+    std::deque<Pipeline_Ctx> _pipeline_wait {};
+    bool _pipeline_writing {false};
+    bool _pipeline_reading {false};
   }; // class Session_Base
 
   class Session final :
@@ -1475,26 +2635,27 @@ public:
 
     void do_close()
     {
+      if (_closing)
+      {
+        return;
+      }
+
       _attr->status = Status::closing;
 
+      // pending operations complete with operation_aborted
+      _closing = true;
+
       cancel_timer();
+      connect_cancel();
 
       error_code ec;
 
-      // shutdown the socket
+      // shutdown the socket, ignoring errors
       _socket.shutdown(tcp::socket::shutdown_both, ec);
       _socket.close(ec);
 
       _attr->status = Status::closed;
 
-      // ignore not_connected error
-      if (ec && ec != boost::system::errc::not_connected)
-      {
-        on_error(ec);
-
-        return;
-      }
-
       if (_attr->on_close)
       {
         try
@@ -1565,6 +2726,18 @@ public:
         return;
       }
 
+      // resume the last session to the host when there is one
+      if (_attr->tls_cache)
+      {
+        SSL_set_ex_data(_socket.native_handle(), tls_index(), _attr.get());
+
+        if (auto const session = _attr->tls_cache->get(tls_key(*_attr)))
+        {
+          SSL_set_session(_socket.native_handle(), session);
+          SSL_SESSION_free(session);
+        }
+      }
+
       do_resolve();
     }
 
@@ -1606,6 +2779,15 @@ public:
 
       _close = false;
 
+      if (SSL_session_reused(_socket.native_handle()))
+      {
+        ++_attr->handshakes_resumed;
+      }
+      else
+      {
+        ++_attr->handshakes_full;
+      }
+
       _attr->status = Status::open;
 
       if (_attr->on_open)
@@ -1626,12 +2808,35 @@ public:
     {
       if (_close)
       {
+        // the shutdown timed out, abort it
+        if (_closing)
+        {
+          error_code ec;
+          _socket.next_layer().close(ec);
+        }
+
         return;
       }
 
+      bool const failed {_attr->status == Status::error};
+
       _attr->status = Status::closing;
 
       _close = true;
+      _closing = true;
+
+      // the stream has failed, skip the shutdown
+      if (failed)
+      {
+        on_shutdown({});
+
+        return;
+      }
+
+      // cancel pending operations before the shutdown
+      error_code ec_cancel;
+      _socket.lowest_layer().cancel(ec_cancel);
+      do_timer();
 
       // shutdown the socket
       _socket.async_shutdown(
@@ -1775,6 +2980,186 @@ public:
     return _attr->timeout;
   }
 
+  // set the lookups to share with other clients
+  Http& dns_cache(std::shared_ptr<Dns_Cache> dns_cache_)
+  {
+    _attr->dns_cache = dns_cache_;
+
+    return *this;
+  }
+
+  // get the lookups shared with other clients
+  std::shared_ptr<Dns_Cache> dns_cache()
+  {
+    return _attr->dns_cache;
+  }
+
+  // set the time to wait on a connection attempt before starting the next
+  Http& connect_delay(std::chrono::milliseconds connect_delay_)
+  {
+    _attr->connect_delay = connect_delay_;
+
+    return *this;
+  }
+
+  // get the time to wait on a connection attempt before starting the next
+  std::chrono::milliseconds connect_delay()
+  {
+    return _attr->connect_delay;
+  }
+
+  // set sending small writes at once instead of coalescing them
+  Http& no_delay(bool no_delay_)
+  {
+    _attr->no_delay = no_delay_;
+
+    return *this;
+  }
+
+  // get sending small writes at once instead of coalescing them
+  bool no_delay()
+  {
+    return _attr->no_delay;
+  }
+
+  // set the socket send buffer size in bytes, 0 keeps the system default
+  Http& send_buffer_size(std::size_t send_buffer_size_)
+  {
+    _attr->send_buffer_size = send_buffer_size_;
+
+    return *this;
+  }
+
+  // get the socket send buffer size in bytes
+  std::size_t send_buffer_size()
+  {
+    return _attr->send_buffer_size;
+  }
+
+  // set the socket receive buffer size in bytes, 0 keeps the system default
+  Http& recv_buffer_size(std::size_t recv_buffer_size_)
+  {
+    _attr->recv_buffer_size = recv_buffer_size_;
+
+    return *this;
+  }
+
+  // get the socket receive buffer size in bytes
+  std::size_t recv_buffer_size()
+  {
+    return _attr->recv_buffer_size;
+  }
+
+  // set sending the first write with the connection request
+  Http& fast_open(bool fast_open_)
+  {
+    _attr->fast_open = fast_open_;
+
+    return *this;
+  }
+
+  // get sending the first write with the connection request
+  bool fast_open()
+  {
+    return _attr->fast_open;
+  }
+
+  // set probing idle connections
+  Http& keep_alive(bool keep_alive_)
+  {
+    _attr->keep_alive = keep_alive_;
+
+    return *this;
+  }
+
+  // get probing idle connections
+  bool keep_alive()
+  {
+    return _attr->keep_alive;
+  }
+
+  // set the idle time before the first probe, 0 keeps the system default
+  Http& keep_alive_idle(std::chrono::seconds keep_alive_idle_)
+  {
+    _attr->keep_alive_idle = keep_alive_idle_;
+
+    return *this;
+  }
+
+  // get the idle time before the first probe
+  std::chrono::seconds keep_alive_idle()
+  {
+    return _attr->keep_alive_idle;
+  }
+
+  // set the time between probes, 0 keeps the system default
+  Http& keep_alive_interval(std::chrono::seconds keep_alive_interval_)
+  {
+    _attr->keep_alive_interval = keep_alive_interval_;
+
+    return *this;
+  }
+
+  // get the time between probes
+  std::chrono::seconds keep_alive_interval()
+  {
+    return _attr->keep_alive_interval;
+  }
+
+  // set the number of unanswered probes before the connection is dropped
+  Http& keep_alive_count(std::size_t keep_alive_count_)
+  {
+    _attr->keep_alive_count = keep_alive_count_;
+
+    return *this;
+  }
+
+  // get the number of unanswered probes before the connection is dropped
+  std::size_t keep_alive_count()
+  {
+    return _attr->keep_alive_count;
+  }
+
+  // set decoding of compressed response bodies
+  Http& decode(bool decode_)
+  {
+    _attr->decode = decode_;
+
+    return *this;
+  }
+
+  // get decoding of compressed response bodies
+  bool decode()
+  {
+    return _attr->decode;
+  }
+
+  // set keeping the response buffer storage between responses
+  Http& recycle(bool recycle_)
+  {
+    _attr->recycle = recycle_;
+
+    return *this;
+  }
+
+  // get keeping the response buffer storage between responses
+  bool recycle()
+  {
+    return _attr->recycle;
+  }
+
+  // get the number of responses read
+  std::size_t responses() const
+  {
+    return _attr->responses;
+  }
+
+  // get the number of heap allocations made reading responses
+  std::size_t allocations() const
+  {
+    return _attr->allocations;
+  }
+
   // get the io_context
   net::io_context& io()
   {
@@ -1809,6 +3194,59 @@ public:
 
     return *this;
   }
+
+  // set the cache of sessions to resume, after the ssl context is set
+  Http& tls_cache(std::shared_ptr<Tls_Cache> tls_cache_)
+  {
+    _attr->tls_cache = tls_cache_;
+
+    // new sessions are passed to the cache as they arrive,
+    // with TLS 1.3 that is after the handshake
+    auto const ctx = _attr->ssl_context.native_handle();
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, [](SSL* ssl_, SSL_SESSION* session_) -> int
+    {
+      auto const attr = static_cast<Attr*>(SSL_get_ex_data(ssl_, tls_index()));
+
+      if (! attr || ! attr->tls_cache)
+      {
+        return 0;
+      }
+
+      attr->tls_cache->put(tls_key(*attr), session_);
+
+      return 1;
+    });
+
+    return *this;
+  }
+
+  // get the number of handshakes that resumed a session
+  std::size_t handshakes_resumed() const
+  {
+    return _attr->handshakes_resumed;
+  }
+
+  // get the number of full handshakes
+  std::size_t handshakes_full() const
+  {
+    return _attr->handshakes_full;
+  }
+
+  // index of the attr on the ssl object,
+  // index 0 is the app data asio keeps its verify callback in
+  static int tls_index()
+  {
+    static int const index {SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr)};
+
+    return index;
+  }
+
+  // key of the sessions to a host
+  static std::string tls_key(Attr const& attr_)
+  {
+    return attr_.address + ":" + std::to_string(static_cast<unsigned int>(attr_.port));
+  }
 #endif // OB_BELLE_CONFIG_SSL_ON
 
   Http& on_open(fn_on_open on_open_)
@@ -1854,7 +3292,7 @@ public:
       // use secure
       auto tmp = std::make_shared<Session_Secure>(_io, _attr);
       tmp->run();
-      _session = tmp.get();
+      _session = tmp;
     }
     else
 #endif // OB_BELLE_CONFIG_SSL_ON
@@ -1862,7 +3300,7 @@ public:
       // use plain
       auto tmp = std::make_shared<Session>(_io, _attr);
       tmp->run();
-      _session = tmp.get();
+      _session = tmp;
     }
 
     return *this;
@@ -1870,52 +3308,76 @@ public:
 
   int status()
   {
-    return _attr->status;
+    return _attr->status.load();
   }
 
   std::string const& status_string()
   {
-    return _status_string.at(static_cast<std::size_t>(_attr->status));
+    return _status_string.at(static_cast<std::size_t>(_attr->status.load()));
   }
 
   bool read()
   {
-    if (_session)
+    if (auto const session = _session.lock())
     {
-      _session->read();
+      session->read();
+
+      return true;
     }
 
-    return _session;
+    return false;
   }
 
   bool write(Request req_)
   {
-    if (_session)
+    if (auto const session = _session.lock())
+    {
+      session->write(std::move(req_));
+
+      return true;
+    }
+
+    return false;
+  }
+
+  // queue a request to be written without waiting on earlier responses,
+  // on_read_ is called with its response, or the on_read callback if empty,
+  // when on_data_ is set, it is called with each part of the body as it is read
+  // and the body is not kept in the response passed to on_read_
+  bool pipeline(Request req_, fn_on_read on_read_ = {}, fn_on_data on_data_ = {})
+  {
+    if (auto const session = _session.lock())
     {
-      _session->write(std::move(req_));
+      session->pipeline(std::move(req_), std::move(on_read_), std::move(on_data_));
+
+      return true;
     }
 
-    return _session;
+    return false;
   }
 
   bool close()
   {
-    if (_session)
+    if (auto const session = _session.lock())
     {
-      _session->close();
+      session->close();
+
+      return true;
     }
 
-    return _session;
+    return false;
   }
 
   bool error(error_code const& ec_ = {})
   {
-    if (_session)
+    if (auto const session = _session.lock())
     {
-      _session->error(ec_);
+      session->error(ec_);
+
+      return true;
     }
 
-    return _session;
+    return false;
   }
 
 private:
@@ -1938,13 +3400,174 @@ private:
   // hold the client attributes
   std::shared_ptr<Attr> const _attr {std::make_shared<Attr>()};
 
-  // the session
-  Session_Type* _session {nullptr};
+  // the session, released once it has finished
+  std::weak_ptr<Session_Type> _session {};
 }; // class Http
 
 } // namespace Client
 #endif // OB_BELLE_CONFIG_CLIENT_ON
 
+// Limiter: a token bucket rate limiter
+// waiting handlers are run in order as tokens become available,
+// each key has its own bucket, the buckets are accessed on a strand
+// making wait and cancel safe to call from any thread
+class Limiter final
+{
+public:
+
+  using fn_on_wait = std::function<void(error_code const&)>;
+
+  Limiter(net::io_context& io_) noexcept :
+    _io {io_},
+    _strand {io_.get_executor()}
+  {
+  }
+
+  // set the number of tokens added per second, zero disables the limit
+  Limiter& rate(double const rate_)
+  {
+    _rate = rate_;
+
+    return *this;
+  }
+
+  // get the number of tokens added per second
+  double rate() const
+  {
+    return _rate;
+  }
+
+  // set the maximum number of tokens a bucket can hold
+  Limiter& burst(std::size_t const burst_)
+  {
+    _burst = static_cast<double>(burst_);
+
+    return *this;
+  }
+
+  // get the maximum number of tokens a bucket can hold
+  std::size_t burst() const
+  {
+    return static_cast<std::size_t>(_burst);
+  }
+
+  // run fn_ once a token from the bucket for key_ is available
+  void wait(std::string const& key_, fn_on_wait fn_)
+  {
+    net::dispatch(_strand, [&, key = key_, fn = std::move(fn_)]() mutable
+    {
+      auto& bucket = _bucket.try_emplace(key, _io, _burst).first->second;
+      bucket.queue.emplace_back(std::move(fn));
+
+      // the timer is already waiting on the earlier handlers
+      if (bucket.queue.size() == 1)
+      {
+        drain(bucket);
+      }
+    });
+  }
+
+  // run all waiting handlers with operation_aborted
+  void cancel()
+  {
+    net::dispatch(_strand, [&]()
+    {
+      for (auto& [key, bucket] : _bucket)
+      {
+        bucket.timer.cancel();
+
+        for (auto& fn : bucket.queue)
+        {
+          net::post(_io, [fn = std::move(fn)]()
+          {
+            fn(net::error::operation_aborted);
+          });
+        }
+
+        bucket.queue.clear();
+      }
+    });
+  }
+
+private:
+
+  using clock = std::chrono::steady_clock;
+
+  struct Bucket
+  {
+    Bucket(net::io_context& io_, double const tokens_) :
+      tokens {tokens_},
+      timer {io_}
+    {
+    }
+
+    // available tokens
+    double tokens;
+
+    // time of the last refill
+    clock::time_point time {clock::now()};
+
+    // handlers waiting on a token
+    std::deque<fn_on_wait> queue {};
+
+    // timer for the next token
+    net::steady_timer timer;
+  }; // struct Bucket
+
+  void drain(Bucket& bucket_)
+  {
+    auto const now = clock::now();
+
+    bucket_.tokens = (std::min)(_burst, bucket_.tokens +
+      std::chrono::duration<double>(now - bucket_.time).count() * _rate);
+    bucket_.time = now;
+
+    while (! bucket_.queue.empty() && (_rate <= 0 || bucket_.tokens >= 1))
+    {
+      if (_rate > 0)
+      {
+        bucket_.tokens -= 1;
+      }
+
+      net::post(_io, [fn = std::move(bucket_.queue.front())]()
+      {
+        fn({});
+      });
+
+      bucket_.queue.pop_front();
+    }
+
+    if (bucket_.queue.empty())
+    {
+      return;
+    }
+
+    // wait until the next token is available
+    bucket_.timer.expires_after(std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>((1 - bucket_.tokens) / _rate)));
+
+    bucket_.timer.async_wait(net::bind_executor(_strand, [&](error_code ec)
+    {
+      if (ec)
+      {
+        return;
+      }
+
+      drain(bucket_);
+    }));
+  }
+
+  net::io_context& _io;
+
+  net::strand<net::io_context::executor_type> _strand;
+
+  double _rate {1};
+
+  double _burst {1};
+
+  std::unordered_map<std::string, Bucket> _bucket;
+}; // class Limiter
+
 #ifdef OB_BELLE_CONFIG_SIGNAL_ON
 class Signal final
 {
@@ -47,9 +47,12 @@ SOFTWARE.
 */
 
 #include "ob/string.hh"
+#include "ob/string_entities.hh"
 
 #include <cstddef>
+#include <cstdint>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -64,6 +67,130 @@ SOFTWARE.
 namespace OB::String
 {
 
+namespace
+{
+
+void utf8_append(char32_t const ch, std::string& res)
+{
+  if (ch < 0x80)
+  {
+    res += static_cast<char>(ch);
+  }
+  else if (ch < 0x800)
+  {
+    res += static_cast<char>(0xc0 | (ch >> 6));
+    res += static_cast<char>(0x80 | (ch & 0x3f));
+  }
+  else if (ch < 0x10000)
+  {
+    res += static_cast<char>(0xe0 | (ch >> 12));
+    res += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+    res += static_cast<char>(0x80 | (ch & 0x3f));
+  }
+  else
+  {
+    res += static_cast<char>(0xf0 | (ch >> 18));
+    res += static_cast<char>(0x80 | ((ch >> 12) & 0x3f));
+    res += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+    res += static_cast<char>(0x80 | (ch & 0x3f));
+  }
+}
+
+// decodes the character reference at the start of str to res,
+// returns the number of bytes read, zero when it is not one
+std::size_t html_entity(std::string_view const str, std::string& res)
+{
+  if (str.size() < 3 || str[0] != '&')
+  {
+    return 0;
+  }
+
+  // numeric reference, '&#<digits>' or '&#x<hex digits>', the ';' is optional
+  if (str[1] == '#')
+  {
+    bool const hex {str[2] == 'x' || str[2] == 'X'};
+    std::size_t pos {hex ? 3u : 2u};
+    std::size_t const begin {pos};
+    char32_t ch {0};
+
+    for (; pos < str.size(); ++pos)
+    {
+      auto const c = str[pos];
+      int val {-1};
+
+      if (c >= '0' && c <= '9')
+      {
+        val = c - '0';
+      }
+      else if (hex && c >= 'a' && c <= 'f')
+      {
+        val = c - 'a' + 10;
+      }
+      else if (hex && c >= 'A' && c <= 'F')
+      {
+        val = c - 'A' + 10;
+      }
+
+      if (val < 0)
+      {
+        break;
+      }
+
+      // out of range values stay out of range
+      if (ch <= 0x10ffff)
+      {
+        ch = ch * (hex ? 16 : 10) + static_cast<char32_t>(val);
+      }
+    }
+
+    if (pos == begin)
+    {
+      return 0;
+    }
+
+    if (pos < str.size() && str[pos] == ';')
+    {
+      ++pos;
+    }
+
+    if (ch == 0 || ch > 0x10ffff || (ch >= 0xd800 && ch <= 0xdfff))
+    {
+      ch = 0xfffd;
+    }
+    else if (ch >= 0x80 && ch <= 0x9f && Entities::c1.at(ch - 0x80))
+    {
+      ch = Entities::c1.at(ch - 0x80);
+    }
+
+    utf8_append(ch, res);
+
+    return pos;
+  }
+
+  // named reference, '&<name>;'
+  auto const end = str.substr(0, 34).find(';', 1);
+
+  if (end == std::string_view::npos)
+  {
+    return 0;
+  }
+
+  auto const name = str.substr(1, end - 1);
+  auto const it = std::lower_bound(Entities::named.begin(), Entities::named.end(), name,
+    [](auto const& lhs, auto const& rhs) { return lhs.first < rhs; });
+
+  if (it == Entities::named.end() || it->first != name)
+  {
+    return 0;
+  }
+
+  res += it->second;
+
+  return end + 1;
+}
+
+} // namespace
+
 std::string replace(std::string str, std::string const& key, std::string const& val,
   std::size_t size)
 {
@@ -95,6 +222,172 @@ std::string replace(std::string str, std::vector<std::pair<std::string, std::str
   return str;
 }
 
+Replace::Replace(std::vector<std::pair<std::string, std::string>> const& vals, bool const entities) :
+  _nodes(1),
+  _entities {entities}
+{
+  for (auto const& [key, val] : vals)
+  {
+    if (key.empty())
+    {
+      continue;
+    }
+
+    std::uint32_t node {0};
+
+    for (auto const c : key)
+    {
+      auto const byte = static_cast<unsigned char>(c);
+      auto& next = _nodes.at(node).next;
+      auto const it = std::find_if(next.begin(), next.end(),
+        [&](auto const& e) { return e.first == byte; });
+
+      if (it != next.end())
+      {
+        node = it->second;
+
+        continue;
+      }
+
+      next.emplace_back(byte, static_cast<std::uint32_t>(_nodes.size()));
+      node = static_cast<std::uint32_t>(_nodes.size());
+      _nodes.emplace_back();
+    }
+
+    // the first of repeated keys is kept
+    if (! _nodes.at(node).val)
+    {
+      _vals.emplace_back(val);
+      _nodes.at(node).val = static_cast<std::uint32_t>(_vals.size());
+    }
+  }
+
+  for (auto const& e : _nodes.front().next)
+  {
+    _first[e.first] = true;
+  }
+
+  if (_entities)
+  {
+    _first['&'] = true;
+  }
+}
+
+void Replace::operator()(std::string_view const str, std::string& res) const
+{
+  res.reserve(res.size() + str.size());
+
+  for (std::size_t i = 0; i < str.size();)
+  {
+    // runs of bytes that can not start a key are appended whole
+    auto pos = i;
+
+    while (pos < str.size() && ! _first[static_cast<unsigned char>(str[pos])])
+    {
+      ++pos;
+    }
+
+    res.append(str.data() + i, pos - i);
+
+    if (pos == str.size())
+    {
+      break;
+    }
+
+    if (_entities && str[pos] == '&')
+    {
+      if (auto const size = html_entity(str.substr(pos), res))
+      {
+        i = pos + size;
+
+        continue;
+      }
+    }
+
+    // the longest key starting at pos
+    std::uint32_t node {0};
+    std::uint32_t val {0};
+    std::size_t size {0};
+
+    for (auto end = pos; end < str.size(); ++end)
+    {
+      auto const byte = static_cast<unsigned char>(str[end]);
+      auto const& next = _nodes[node].next;
+      auto const it = std::find_if(next.begin(), next.end(),
+        [&](auto const& e) { return e.first == byte; });
+
+      if (it == next.end())
+      {
+        break;
+      }
+
+      node = it->second;
+
+      if (_nodes[node].val)
+      {
+        val = _nodes[node].val;
+        size = end + 1 - pos;
+      }
+    }
+
+    if (val)
+    {
+      res += _vals[val - 1];
+      i = pos + size;
+    }
+    else
+    {
+      res += str[pos];
+      i = pos + 1;
+    }
+  }
+}
+
+std::string Replace::operator()(std::string_view const str) const
+{
+  std::string res;
+  (*this)(str, res);
+
+  return res;
+}
+
+void html_decode(std::string_view const str, std::string& res)
+{
+  res.reserve(res.size() + str.size());
+
+  for (std::size_t i = 0; i < str.size();)
+  {
+    auto const pos = str.find('&', i);
+
+    if (pos == std::string_view::npos)
+    {
+      res.append(str.data() + i, str.size() - i);
+
+      break;
+    }
+
+    res.append(str.data() + i, pos - i);
+
+    if (auto const size = html_entity(str.substr(pos), res))
+    {
+      i = pos + size;
+    }
+    else
+    {
+      res += '&';
+      i = pos + 1;
+    }
+  }
+}
+
+std::string html_decode(std::string_view const str)
+{
+  std::string res;
+  html_decode(str, res);
+
+  return res;
+}
+
 std::string to_string(double const val, int const pre)
 {
   std::stringstream ss;
@@ -50,8 +50,11 @@ SOFTWARE.
 #define OB_STRING_HH
 
 #include <cstddef>
+#include <cstdint>
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <regex>
 #include <limits>
@@ -65,6 +68,47 @@ std::string replace(std::string str, std::string const& key, std::string const&
 
 std::string replace(std::string str, std::vector<std::pair<std::string, std::string>> const& vals);
 
+// replaces many keys in a single pass, at each position the longest key
+// starting there is replaced, optionally decoding HTML character
+// references in the same pass, built once and reused
+class Replace final
+{
+public:
+
+  Replace(std::vector<std::pair<std::string, std::string>> const& vals, bool const entities = false);
+
+  // appends str with the keys replaced to res
+  void operator()(std::string_view const str, std::string& res) const;
+
+  std::string operator()(std::string_view const str) const;
+
+private:
+
+  struct Node
+  {
+    // child node of each next byte
+    std::vector<std::pair<unsigned char, std::uint32_t>> next;
+
+    // index plus one of the value of the key ending here, zero when none
+    std::uint32_t val {0};
+  }; // struct Node
+
+  // key trie, the first node is the root
+  std::vector<Node> _nodes;
+
+  std::vector<std::string> _vals;
+
+  // bytes that can start a key or a character reference
+  std::array<bool, 256> _first {};
+
+  bool _entities {false};
+}; // class Replace
+
+// appends str with its HTML named and numeric character references decoded to res
+void html_decode(std::string_view const str, std::string& res);
+
+std::string html_decode(std::string_view const str);
+
 std::string to_string(double const val, int const pre = 2);
 
 std::vector<std::string> split(std::string const& str, std::string const& delim,
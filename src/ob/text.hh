@@ -70,6 +70,7 @@ SOFTWARE.
 #include <vector>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <iterator>
 #include <algorithm>
@@ -1134,6 +1135,274 @@ public:
   std::string str;
 }; // class Char32
 
+// compiled regex pattern, parsed once and shared,
+// hands out matchers that can be reset to new input
+class Regex_Pattern
+{
+public:
+
+  using char_type = char;
+  using string_view = std::basic_string_view<char_type>;
+  using pattern = icu::RegexPattern;
+  using regex = icu::RegexMatcher;
+
+  Regex_Pattern() = delete;
+  Regex_Pattern(Regex_Pattern&&) = default;
+  Regex_Pattern(Regex_Pattern const&) = delete;
+
+  Regex_Pattern(string_view rx, std::uint32_t flags = UREGEX_CASE_INSENSITIVE)
+  {
+    UErrorCode ec = U_ZERO_ERROR;
+
+    std::unique_ptr<UText, decltype(&utext_close)> urx (
+      utext_openUTF8(nullptr, rx.data(), static_cast<std::int64_t>(rx.size()), &ec),
+      utext_close);
+
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to create utext");
+    }
+
+    UParseError pe;
+
+    _pattern.reset(pattern::compile(urx.get(), flags, pe, ec));
+
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to compile regex pattern");
+    }
+  }
+
+  ~Regex_Pattern() = default;
+
+  Regex_Pattern& operator=(Regex_Pattern&&) = default;
+  Regex_Pattern& operator=(Regex_Pattern const&) = delete;
+
+  // the pattern is immutable, matchers can be created from any thread
+  std::unique_ptr<regex> matcher() const
+  {
+    UErrorCode ec = U_ZERO_ERROR;
+
+    std::unique_ptr<regex> iter {_pattern->matcher(ec)};
+
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to create regex matcher");
+    }
+
+    return iter;
+  }
+
+  pattern const& get() const
+  {
+    return *_pattern;
+  }
+
+private:
+
+  std::unique_ptr<pattern> _pattern;
+}; // class Regex_Pattern
+
+// lazy range over the matches of a pattern in a string,
+// each match is found as the iterator advances, stopping early
+// skips the rest of the string
+class Regex_Range
+{
+public:
+
+  using size_type = std::size_t;
+  using char_type = char;
+  using string_view = std::basic_string_view<char_type>;
+  using regex = icu::RegexMatcher;
+
+  // view of the current match, valid until the iterator advances
+  class Match
+  {
+  public:
+
+    Match(regex& iter, string_view str) :
+      _iter {iter},
+      _str {str}
+    {
+    }
+
+    size_type pos() const
+    {
+      return span(0).first;
+    }
+
+    // number of capture groups
+    size_type size() const
+    {
+      return static_cast<size_type>(_iter.groupCount());
+    }
+
+    string_view str() const
+    {
+      auto const [begin, end] = span(0);
+
+      return _str.substr(begin, end - begin);
+    }
+
+    // capture group, zero based like Regex::Match::group
+    string_view group(size_type pos) const
+    {
+      auto const [begin, end] = span(static_cast<std::int32_t>(pos) + 1);
+
+      return _str.substr(begin, end - begin);
+    }
+
+  private:
+
+    std::pair<size_type, size_type> span(std::int32_t group) const
+    {
+      UErrorCode ec = U_ZERO_ERROR;
+
+      auto const begin = _iter.start(group, ec);
+
+      if (U_FAILURE(ec))
+      {
+        throw std::runtime_error("failed to get regex matcher group start");
+      }
+
+      auto const end = _iter.end(group, ec);
+
+      if (U_FAILURE(ec))
+      {
+        throw std::runtime_error("failed to get regex matcher group end");
+      }
+
+      // an unmatched group has no position
+      if (begin < 0)
+      {
+        return {0, 0};
+      }
+
+      return {static_cast<size_type>(begin), static_cast<size_type>(end)};
+    }
+
+    regex& _iter;
+    string_view _str;
+  }; // class Match
+
+  // single pass input iterator, all copies share the matcher
+  class iterator
+  {
+  public:
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Match;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Match const*;
+    using reference = Match const&;
+
+    iterator() = default;
+
+    iterator(Regex_Range& range) :
+      _range {&range},
+      _match {std::in_place, *range._iter, range._str}
+    {
+      next();
+    }
+
+    reference operator*() const
+    {
+      return *_match;
+    }
+
+    pointer operator->() const
+    {
+      return &*_match;
+    }
+
+    iterator& operator++()
+    {
+      next();
+
+      return *this;
+    }
+
+    bool operator==(iterator const& rhs) const
+    {
+      return _range == rhs._range;
+    }
+
+    bool operator!=(iterator const& rhs) const
+    {
+      return _range != rhs._range;
+    }
+
+  private:
+
+    void next()
+    {
+      if (! _range->_iter->find())
+      {
+        _range = nullptr;
+      }
+    }
+
+    Regex_Range* _range {nullptr};
+    std::optional<Match> _match;
+  }; // class iterator
+
+  Regex_Range(Regex_Pattern const& rx, string_view str) :
+    _own {rx.matcher()}
+  {
+    init(*_own, str);
+  }
+
+  Regex_Range(regex& iter, string_view str)
+  {
+    init(iter, str);
+  }
+
+  Regex_Range(Regex_Range&&) = delete;
+  Regex_Range(Regex_Range const&) = delete;
+  ~Regex_Range() = default;
+
+  Regex_Range& operator=(Regex_Range&&) = delete;
+  Regex_Range& operator=(Regex_Range const&) = delete;
+
+  iterator begin()
+  {
+    return iterator(*this);
+  }
+
+  iterator end()
+  {
+    return iterator();
+  }
+
+private:
+
+  void init(regex& iter, string_view str)
+  {
+    UErrorCode ec = U_ZERO_ERROR;
+
+    _ustr.reset(utext_openUTF8(nullptr, str.data(), static_cast<std::int64_t>(str.size()), &ec));
+
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to create utext");
+    }
+
+    _iter = &iter;
+    _str = str;
+    _iter->reset(_ustr.get());
+  }
+
+  // matcher owned by the range, when not borrowed
+  std::unique_ptr<regex> _own;
+
+  // matcher being advanced
+  regex* _iter {nullptr};
+
+  string_view _str;
+
+  std::unique_ptr<UText, decltype(&utext_close)> _ustr {nullptr, utext_close};
+}; // class Regex_Range
+
 class Regex
 {
 public:
@@ -1167,17 +1436,33 @@ public:
 
   Regex() = default;
   Regex(Regex&&) = default;
-  Regex(Regex const&) = default;
+
+  // the matcher is not shared between copies
+  Regex(Regex const& obj) :
+    _str {obj._str}
+  {
+  }
 
   Regex(string_view rx, string_view str)
   {
     match(rx, str);
   }
 
+  Regex(Regex_Pattern const& rx, string_view str)
+  {
+    match(rx, str);
+  }
+
   ~Regex() = default;
 
   Regex& operator=(Regex&&) = default;
-  Regex& operator=(Regex const&) = default;
+
+  Regex& operator=(Regex const& obj)
+  {
+    _str = obj._str;
+
+    return *this;
+  }
 
   Regex& match(string_view rx, string_view str)
   {
@@ -1218,61 +1503,52 @@ public:
 
     iter->reset(ustr.get());
 
-    size_type size {0};
-    std::int32_t count {0};
-    std::int32_t begin {0};
-    std::int32_t end {0};
+    return collect(*iter, str);
+  }
 
-    while (iter->find())
+  // lazy range over the matches, reuses the matcher like match
+  Regex_Range find(Regex_Pattern const& rx, string_view str)
+  {
+    if (! _matcher || _pattern != &rx)
     {
-      count = iter->groupCount();
-
-      begin = iter->start(ec);
-
-      if (U_FAILURE(ec))
-      {
-        throw std::runtime_error("failed to get regex matcher start");
-      }
-
-      end = iter->end(ec);
-
-      if (U_FAILURE(ec))
-      {
-        throw std::runtime_error("failed to get regex matcher end");
-      }
-
-      size = static_cast<size_type>(end - begin);
-
-      Match match;
-      match.pos = static_cast<size_type>(begin);
-      match.size = static_cast<size_type>(count);
-      match.str = string_view(str.data() + begin, size);
+      _matcher = rx.matcher();
+      _pattern = &rx;
+    }
 
-      for (std::int32_t i = 1; i <= count; ++i)
-      {
-        begin = iter->start(i, ec);
+    return Regex_Range(*_matcher, str);
+  }
 
-        if (U_FAILURE(ec))
-        {
-          throw std::runtime_error("failed to get regex matcher group start");
-        }
+  // reuses the matcher and the match storage from the previous call
+  // with the same pattern
+  Regex& match(Regex_Pattern const& rx, string_view str)
+  {
+    _str.clear();
 
-        end = iter->end(i, ec);
+    if (str.empty())
+    {
+      return *this;
+    }
 
-        if (U_FAILURE(ec))
-        {
-          throw std::runtime_error("failed to get regex matcher group end");
-        }
+    if (! _matcher || _pattern != &rx)
+    {
+      _matcher = rx.matcher();
+      _pattern = &rx;
+    }
 
-        size = static_cast<size_type>(end - begin);
+    UErrorCode ec = U_ZERO_ERROR;
 
-        match.group.emplace_back(string_view(str.data() + begin, size));
-      }
+    std::unique_ptr<UText, decltype(&utext_close)> ustr (
+      utext_openUTF8(nullptr, str.data(), static_cast<std::int64_t>(str.size()), &ec),
+      utext_close);
 
-      _str.emplace_back(match);
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to create utext");
     }
 
-    return *this;
+    _matcher->reset(ustr.get());
+
+    return collect(*_matcher, str);
   }
 
   value_type const& get() const
@@ -1361,7 +1637,74 @@ public:
 
 private:
 
+  Regex& collect(regex& iter, string_view str)
+  {
+    UErrorCode ec = U_ZERO_ERROR;
+
+    size_type size {0};
+    std::int32_t count {0};
+    std::int32_t begin {0};
+    std::int32_t end {0};
+
+    while (iter.find())
+    {
+      count = iter.groupCount();
+
+      begin = iter.start(ec);
+
+      if (U_FAILURE(ec))
+      {
+        throw std::runtime_error("failed to get regex matcher start");
+      }
+
+      end = iter.end(ec);
+
+      if (U_FAILURE(ec))
+      {
+        throw std::runtime_error("failed to get regex matcher end");
+      }
+
+      size = static_cast<size_type>(end - begin);
+
+      Match match;
+      match.pos = static_cast<size_type>(begin);
+      match.size = static_cast<size_type>(count);
+      match.str = string_view(str.data() + begin, size);
+
+      for (std::int32_t i = 1; i <= count; ++i)
+      {
+        begin = iter.start(i, ec);
+
+        if (U_FAILURE(ec))
+        {
+          throw std::runtime_error("failed to get regex matcher group start");
+        }
+
+        end = iter.end(i, ec);
+
+        if (U_FAILURE(ec))
+        {
+          throw std::runtime_error("failed to get regex matcher group end");
+        }
+
+        size = static_cast<size_type>(end - begin);
+
+        match.group.emplace_back(string_view(str.data() + begin, size));
+      }
+
+      _str.emplace_back(match);
+    }
+
+    return *this;
+  }
+
   value_type _str;
+
+  // pattern of the reused matcher
+  Regex_Pattern const* _pattern {nullptr};
+
+  // matcher reused across calls with the same pattern
+  std::unique_ptr<regex> _matcher;
 }; // class Regex
 
 inline std::string lowercase(std::string_view const str)
@@ -1482,6 +1825,28 @@ inline std::string normalize_foldcase(std::string_view const str)
   return res;
 }
 
+// key for caseless comparison, the NFKC case folding of str,
+// ASCII text is only lowercased, which folds it the same
+inline std::string fold_key(std::string_view const str)
+{
+  if (std::all_of(str.begin(), str.end(), [](char const c) { return (c & 0x80) == 0; }))
+  {
+    std::string res {str};
+
+    for (auto& c : res)
+    {
+      if (c >= 'A' && c <= 'Z')
+      {
+        c += 'a' - 'A';
+      }
+    }
+
+    return res;
+  }
+
+  return normalize_foldcase(str);
+}
+
 inline std::int32_t to_int32(std::string_view const str)
 {
   if (str.empty())